@@ -0,0 +1,218 @@
+#include "App.h"
+
+#include <fcntl.h>         // For open()
+#include <unistd.h>        // For close(), usleep()
+#include <sys/ioctl.h>     // For ioctl()
+#include <linux/i2c.h>     // For struct i2c_msg
+#include <linux/i2c-dev.h> // For I2C definitions
+#include <stdexcept>
+#include <utility>
+
+// CONFIG: 0.5 ms standby, filter off. CTRL_MEAS: oversampling x1/x1, normal
+// mode. One conversion then takes at most 6.4 ms, so the sensor refreshes
+// its data registers at well over 100 Hz.
+static const uint8_t kConfig = 0x00;
+static const uint8_t kCtrlMeas = 0x27;
+static const uint8_t kCtrlMeasSleep = kCtrlMeas & ~0x03;
+static const useconds_t kFirstConversionUs = 10000;
+
+BMP280Session::BMP280Session(const char *bus, uint8_t addr) : fd_(-1), addr_(addr), calib_{}, folded_{} {
+    // 1. Open I2C bus once for the lifetime of the session
+    fd_ = open(bus, O_RDWR);
+    if (fd_ < 0) {
+        throw std::runtime_error("Cannot open I2C bus");
+    }
+
+    // 2. Select BMP280 device address for the plain write() path
+    if (ioctl(fd_, I2C_SLAVE, addr_) < 0) {
+        close();
+        throw std::runtime_error("Cannot connect to BMP280");
+    }
+
+    try {
+        // 3. Read the 24 calibration bytes (0x88-0xA1) once and cache them
+        uint8_t calib[24];
+        readRegisters(0x88, calib, sizeof(calib));
+
+        // Convert bytes to constants (little-endian)
+        calib_.dig_T1 = (calib[1] << 8) | calib[0];
+        calib_.dig_T2 = (calib[3] << 8) | calib[2];
+        calib_.dig_T3 = (calib[5] << 8) | calib[4];
+
+        calib_.dig_P1 = (calib[7] << 8) | calib[6];
+        calib_.dig_P2 = (calib[9] << 8) | calib[8];
+        calib_.dig_P3 = (calib[11] << 8) | calib[10];
+        calib_.dig_P4 = (calib[13] << 8) | calib[12];
+        calib_.dig_P5 = (calib[15] << 8) | calib[14];
+        calib_.dig_P6 = (calib[17] << 8) | calib[16];
+        calib_.dig_P7 = (calib[19] << 8) | calib[18];
+        calib_.dig_P8 = (calib[21] << 8) | calib[20];
+        calib_.dig_P9 = (calib[23] << 8) | calib[22];
+        folded_ = foldBMP280(calib_);
+
+        // 4. Configure once; CONFIG is only guaranteed to stick outside
+        //    normal mode, and a previous run may have left the sensor
+        //    streaming, so put it to sleep before writing it
+        writeRegister(0xF4, kCtrlMeasSleep);
+        writeRegister(0xF5, kConfig);
+        writeRegister(0xF4, kCtrlMeas);
+    } catch (...) {
+        close();
+        throw;
+    }
+
+    // 5. Let the first conversion land so read() never returns the reset value
+    usleep(kFirstConversionUs);
+}
+
+BMP280Session::~BMP280Session() {
+    close();
+}
+
+BMP280Session::BMP280Session(BMP280Session &&other) noexcept
+    : fd_(std::exchange(other.fd_, -1)), addr_(other.addr_), calib_(other.calib_), folded_(other.folded_) {
+}
+
+BMP280Session &BMP280Session::operator=(BMP280Session &&other) noexcept {
+    if (this != &other) {
+        close();
+        fd_ = std::exchange(other.fd_, -1);
+        addr_ = other.addr_;
+        calib_ = other.calib_;
+        folded_ = other.folded_;
+    }
+    return *this;
+}
+
+void BMP280Session::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void BMP280Session::readRegisters(uint8_t reg, uint8_t *buf, uint16_t len) const {
+    // Register pointer write and data read as one combined transaction
+    struct i2c_msg msgs[2];
+    msgs[0].addr = addr_;
+    msgs[0].flags = 0;
+    msgs[0].len = 1;
+    msgs[0].buf = &reg;
+    msgs[1].addr = addr_;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = len;
+    msgs[1].buf = buf;
+
+    struct i2c_rdwr_ioctl_data xfer;
+    xfer.msgs = msgs;
+    xfer.nmsgs = 2;
+    if (ioctl(fd_, I2C_RDWR, &xfer) < 0) {
+        throw std::runtime_error("Cannot read BMP280");
+    }
+}
+
+void BMP280Session::writeRegister(uint8_t reg, uint8_t value) const {
+    uint8_t buf[2] = {reg, value};
+    if (write(fd_, buf, 2) != 2) {
+        throw std::runtime_error("Cannot write BMP280");
+    }
+}
+
+BMP280RawData BMP280Session::readRaw() const {
+    BMP280RawData data{};
+    data.calib = calib_;
+
+    // Raw pressure and temperature (6 bytes from 0xF7)
+    uint8_t raw[6];
+    readRegisters(0xF7, raw, sizeof(raw));
+
+    // Convert bytes into 20-bit raw values
+    data.adc_P = ((int32_t)raw[0] << 12) | ((int32_t)raw[1] << 4) | ((int32_t)raw[2] >> 4);
+    data.adc_T = ((int32_t)raw[3] << 12) | ((int32_t)raw[4] << 4) | ((int32_t)raw[5] >> 4);
+    return data;
+}
+
+BMP280Compensated BMP280Session::read() const {
+    return compensateBMP280(readRaw(), folded_);
+}
+
+BMP280RawData readBMP280Data() {
+    BMP280Session session;
+    return session.readRaw();
+}
+
+BMP280Compensated compensateBMP280(const BMP280RawData &data) {
+    BMP280Compensated result;
+
+    // ------------------------
+    // Temperature Compensation
+    // ------------------------
+    int32_t adc_T = data.adc_T;
+    const auto &c = data.calib;
+
+    // Use floating-point formula from datasheet
+    double var1 = (adc_T / 16384.0 - c.dig_T1 / 1024.0) * c.dig_T2;
+    double var2 = ((adc_T / 131072.0 - c.dig_T1 / 8192.0) * (adc_T / 131072.0 - c.dig_T1 / 8192.0)) * c.dig_T3;
+    double t_fine = var1 + var2;
+
+    result.temperature = t_fine / 5120.0;
+
+    // ------------------------
+    // Pressure Compensation
+    // ------------------------
+    int32_t adc_P = data.adc_P;
+
+    double varP1 = t_fine / 2.0 - 64000.0;
+    double varP2 = varP1 * varP1 * c.dig_P6 / 32768.0;
+    varP2 = varP2 + varP1 * c.dig_P5 * 2.0;
+    varP2 = varP2 / 4.0 + c.dig_P4 * 65536.0;
+    double varP3 = (c.dig_P3 * varP1 * varP1 / 524288.0 + c.dig_P2 * varP1) / 524288.0;
+    varP1 = (1.0 + varP3 / 32768.0) * c.dig_P1;
+
+    double pressure = 1048576.0 - adc_P;
+    pressure = (pressure - varP2 / 4096.0) * 6250.0 / varP1;
+
+    varP1 = c.dig_P9 * pressure * pressure / 2147483648.0;
+    varP2 = pressure * c.dig_P8 / 32768.0;
+    pressure = pressure + (varP1 + varP2 + c.dig_P7) / 16.0;
+
+    // Convert from Pa to hPa
+    result.pressure = pressure / 100.0;
+
+    return result;
+}
+
+BMP280Folded foldBMP280(const Registers &c) {
+    BMP280Folded f;
+
+    // Temperature: both brackets of the datasheet formula are multiples of
+    // x = adc_T / 131072 - T1 / 8192
+    f.t_offset = -c.dig_T1 / 8192.0;
+    f.t_lin = 8.0 * c.dig_T2;
+    f.t_quad = c.dig_T3;
+
+    // Pressure: var2 / 4096 and var1 / 6250 expanded as polynomials in v
+    f.p_num0 = 1048576.0 - 16.0 * c.dig_P4;
+    f.p_num1 = c.dig_P5 / 8192.0;
+    f.p_num2 = c.dig_P6 / 536870912.0;
+    f.p_den0 = c.dig_P1 / 6250.0;
+    f.p_den1 = c.dig_P1 * (double)c.dig_P2 / 17179869184.0 / 6250.0;
+    f.p_den2 = c.dig_P1 * (double)c.dig_P3 / 9007199254740992.0 / 6250.0;
+    f.p_out0 = c.dig_P7 / 16.0;
+    f.p_out1 = 1.0 + c.dig_P8 / 524288.0;
+    f.p_out2 = c.dig_P9 / 34359738368.0;
+    return f;
+}
+
+BMP280Compensated compensateBMP280(const BMP280RawData &data, const BMP280Folded &f) {
+    BMP280Compensated result;
+
+    double x = data.adc_T / 131072.0 + f.t_offset;
+    double t_fine = x * (f.t_lin + f.t_quad * x);
+    result.temperature = t_fine / 5120.0;
+
+    double v = t_fine / 2.0 - 64000.0;
+    double p = (f.p_num0 - data.adc_P - v * (f.p_num1 + v * f.p_num2)) / (f.p_den0 + v * (f.p_den1 + v * f.p_den2));
+    result.pressure = (f.p_out0 + p * (f.p_out1 + f.p_out2 * p)) / 100.0;
+    return result;
+}
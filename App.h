@@ -1,17 +1,7 @@
 #ifndef APP_H
 #define APP_H
 
-    #include <iostream>
-    #include <fcntl.h>         // For open()
-    #include <unistd.h>        // For read(), write(), close(), usleep()
-    #include <sys/ioctl.h>     // For ioctl()
-    #include <linux/i2c-dev.h> // For I2C definitions
     #include <cstdint>         // For fixed-width integers like uint8_t
-    #include "driver_bmp280.h"
-
-    using std::cerr;
-    using std::cout;
-    using std::endl;
 
     // Linux exposes the I2C bus as a device file.
     // On modern Raspberry Pi models, I2C bus 1 is /dev/i2c-1.
@@ -24,12 +14,12 @@
 
     struct Registers{
         // Temperature registers
-        int16_t dig_T1;
+        uint16_t dig_T1;
         int16_t  dig_T2;
         int16_t  dig_T3;
 
         // Pressure registers
-        int16_t dig_P1;
+        uint16_t dig_P1;
         int16_t dig_P2;
         int16_t dig_P3;
         int16_t dig_P4;
@@ -51,107 +41,76 @@
         double pressure;    // in hPa
     };
 
-    BMP280RawData readBMP280Data() {
-        BMP280RawData data{};
-        
-        // 1. Open I2C bus
-        int file = open(I2C_BUS, O_RDWR);
-        if (file < 0) {
-            throw std::runtime_error("Cannot open I2C bus");
-        }
-
-        // 2. Select BMP280 device address
-        if (ioctl(file, I2C_SLAVE, BMP280_ADDR) < 0) {
-            close(file);
-            throw std::runtime_error("Cannot connect to BMP280");
-        }
-
-        // -------------------------
-        // 3. Read 24 calibration bytes (0x88-0xA1)
-        // -------------------------
-        uint8_t reg = 0x88;           // start register
-        write(file, &reg, 1);          // set pointer
-        uint8_t calib[24];
-        read(file, calib, 24);         // read all 24 bytes
-
-        // Convert bytes to constants (little-endian)
-        data.calib.dig_T1 = (calib[1] << 8) | calib[0];
-        data.calib.dig_T2 = (calib[3] << 8) | calib[2];
-        data.calib.dig_T3 = (calib[5] << 8) | calib[4];
-
-        data.calib.dig_P1 = (calib[7] << 8) | calib[6];
-        data.calib.dig_P2 = (calib[9] << 8) | calib[8];
-        data.calib.dig_P3 = (calib[11] << 8) | calib[10];
-        data.calib.dig_P4 = (calib[13] << 8) | calib[12];
-        data.calib.dig_P5 = (calib[15] << 8) | calib[14];
-        data.calib.dig_P6 = (calib[17] << 8) | calib[16];
-        data.calib.dig_P7 = (calib[19] << 8) | calib[18];
-        data.calib.dig_P8 = (calib[21] << 8) | calib[20];
-        data.calib.dig_P9 = (calib[23] << 8) | calib[22];
-
-        // -------------------------
-        // 4. Configure sensor for measurement
-        // -------------------------
-        uint8_t ctrl[2] = {0xF4, 0x27}; // normal mode, oversampling x1
-        write(file, ctrl, 2);
-
-        usleep(100000); // wait 100ms for measurement
-
-        // -------------------------
-        // 5. Read raw pressure and temperature (6 bytes from 0xF7)
-        // -------------------------
-        reg = 0xF7;                  // start register for raw data
-        write(file, &reg, 1);        // set pointer
-        uint8_t raw[6];
-        read(file, raw, 6);          // read 6 bytes
-
-        // Convert bytes into 20-bit raw values
-        data.adc_P = ((int32_t)raw[0] << 12) | ((int32_t)raw[1] << 4) | ((int32_t)raw[2] >> 4);
-        data.adc_T = ((int32_t)raw[3] << 12) | ((int32_t)raw[4] << 4) | ((int32_t)raw[5] >> 4);
-
-        close(file);
-        return data;
-}
-
-BMP280Compensated compensateBMP280(const BMP280RawData &data) {
-    BMP280Compensated result;
-
-    // ------------------------
-    // Temperature Compensation
-    // ------------------------
-    int32_t adc_T = data.adc_T;
-    const auto &c = data.calib;
-
-    // Use floating-point formula from datasheet
-    double var1 = (adc_T / 16384.0 - c.dig_T1 / 1024.0) * c.dig_T2;
-    double var2 = ((adc_T / 131072.0 - c.dig_T1 / 8192.0) * (adc_T / 131072.0 - c.dig_T1 / 8192.0)) * c.dig_T3;
-    double t_fine = var1 + var2;
-
-    result.temperature = t_fine / 5120.0;
-
-    // ------------------------
-    // Pressure Compensation
-    // ------------------------
-    int32_t adc_P = data.adc_P;
-
-    double varP1 = t_fine / 2.0 - 64000.0;
-    double varP2 = varP1 * varP1 * c.dig_P6 / 32768.0;
-    varP2 = varP2 + varP1 * c.dig_P5 * 2.0;
-    varP2 = varP2 / 4.0 + c.dig_P4 * 65536.0;
-    double varP3 = (c.dig_P3 * varP1 * varP1 / 524288.0 + c.dig_P2 * varP1) / 524288.0;
-    varP1 = (1.0 + varP3 / 32768.0) * c.dig_P1;
-
-    double pressure = 1048576.0 - adc_P;
-    pressure = (pressure - varP2 / 4096.0) * 6250.0 / varP1;
-
-    varP1 = c.dig_P9 * pressure * pressure / 2147483648.0;
-    varP2 = pressure * c.dig_P8 / 32768.0;
-    pressure = pressure + (varP1 + varP2 + c.dig_P7) / 16.0;
-
-    // Convert from Pa to hPa
-    result.pressure = pressure / 100.0;
-
-    return result;
-}
-
-#endif
\ No newline at end of file
+    // The calibration-only terms of the double formula, folded once into
+    // polynomial coefficients (same shape as bmp280_coefficients_t):
+    //   x = adc_T / 2^17 + t_offset, t_fine = x * (t_lin + t_quad * x)
+    //   v = t_fine / 2 - 64000
+    //   p = (p_num0 - adc_P - v * (p_num1 + v * p_num2)) / (p_den0 + v * (p_den1 + v * p_den2))
+    //   pressure = p_out0 + p * (p_out1 + p_out2 * p)
+    struct BMP280Folded {
+        double t_offset;    // -T1 / 2^13
+        double t_lin;       // 8 * T2
+        double t_quad;      // T3
+        double p_num0;      // 2^20 - 16 * P4
+        double p_num1;      // P5 / 2^13
+        double p_num2;      // P6 / 2^29
+        double p_den0;      // P1 / 6250
+        double p_den1;      // P1 * P2 / 2^34 / 6250
+        double p_den2;      // P1 * P3 / 2^53 / 6250
+        double p_out0;      // P7 / 2^4
+        double p_out1;      // 1 + P8 / 2^19
+        double p_out2;      // P9 / 2^35
+    };
+
+    // An open BMP280 on one I2C bus.
+    //
+    // The constructor opens the bus, reads the calibration once and puts the
+    // sensor into free-running normal mode; read() is then a single combined
+    // I2C transaction plus the compensation math on the coefficients folded
+    // from that calibration. The fd is closed when the session goes out of
+    // scope. Errors throw std::runtime_error.
+    class BMP280Session {
+    public:
+        explicit BMP280Session(const char *bus = I2C_BUS, uint8_t addr = BMP280_ADDR);
+        ~BMP280Session();
+
+        BMP280Session(const BMP280Session &) = delete;
+        BMP280Session &operator=(const BMP280Session &) = delete;
+        BMP280Session(BMP280Session &&other) noexcept;
+        BMP280Session &operator=(BMP280Session &&other) noexcept;
+
+        // Latest raw conversion together with the cached calibration
+        BMP280RawData readRaw() const;
+
+        // Latest conversion, compensated
+        BMP280Compensated read() const;
+
+        const Registers &calibration() const { return calib_; }
+        const BMP280Folded &folded() const { return folded_; }
+
+    private:
+        void readRegisters(uint8_t reg, uint8_t *buf, uint16_t len) const;
+        void writeRegister(uint8_t reg, uint8_t value) const;
+        void close();
+
+        int fd_;
+        uint8_t addr_;
+        Registers calib_;
+        BMP280Folded folded_;
+    };
+
+    // One-shot read: opens a session, takes one conversion and closes it.
+    // Prefer a long-lived BMP280Session when reading repeatedly.
+    BMP280RawData readBMP280Data();
+
+    BMP280Folded foldBMP280(const Registers &calib);
+
+    // Datasheet double formula, term by term from the raw calibration. Kept
+    // as the reference the other compensation paths are checked against.
+    BMP280Compensated compensateBMP280(const BMP280RawData &data);
+
+    // The same formula on coefficients folded once per calibration; equal
+    // to the reference up to double rounding. data.calib is not used.
+    BMP280Compensated compensateBMP280(const BMP280RawData &data, const BMP280Folded &folded);
+
+#endif
@@ -0,0 +1,178 @@
+#include "BusWorker.h"
+
+BusWorker::BusWorker(const BusBackend &backend, size_t depth)
+    : backend_(backend), submissions_(depth), completions_(depth) {
+    thread_ = std::thread(&BusWorker::run, this);
+}
+
+BusWorker::~BusWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_.store(true);
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+bool BusWorker::submit(const BusTransfer &xfer) {
+    if (!submissions_.push(xfer))
+        return false;
+
+    // Counted once the cell is filled, so a wake-up always finds it. The
+    // worker may pop the transfer first and take the count below zero for
+    // a moment; it only sleeps while the count is not positive, and the
+    // last submitter of anything it has not seen yet sees it sleeping
+    pending_.fetch_add(1);
+    if (sleeping_.load()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wake_.notify_one();
+    }
+    return true;
+}
+
+std::future<uint8_t> BusWorker::submitFuture(BusTransfer xfer) {
+    std::promise<uint8_t> *promise = new std::promise<uint8_t>();
+    std::future<uint8_t> future = promise->get_future();
+
+    xfer.ctx = promise;
+    xfer.callback = [](void *ctx, const BusTransfer &, uint8_t result) {
+        std::promise<uint8_t> *p = static_cast<std::promise<uint8_t> *>(ctx);
+        p->set_value(result);
+        delete p;
+    };
+    if (!submit(xfer)) {
+        promise->set_value(1);
+        delete promise;
+    }
+    return future;
+}
+
+size_t BusWorker::poll(BusCompletion *out, size_t max) {
+    size_t n = 0;
+    while (n < max && completions_.pop(out[n]))
+        n++;
+    return n;
+}
+
+void BusWorker::run() {
+    std::vector<BusTransfer> batch;
+    BusTransfer xfer;
+
+    for (;;) {
+        // Take everything queued so far and put it on the bus in one go;
+        // transfers from different sensors end up back to back
+        while (submissions_.pop(xfer))
+            batch.push_back(xfer);
+        if (!batch.empty()) {
+            pending_.fetch_sub((int64_t)batch.size());
+            batches_.fetch_add(1, std::memory_order_relaxed);
+            execute(batch);
+            batch.clear();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stop_.load())
+            break;
+        sleeping_.store(true);
+        wake_.wait(lock, [this] { return pending_.load() > 0 || stop_.load(); });
+        sleeping_.store(false);
+    }
+}
+
+void BusWorker::execute(std::vector<BusTransfer> &batch) {
+    std::vector<bmp280_interface_iic_read_t> reads;
+    size_t i = 0;
+
+    while (i < batch.size()) {
+        const BusTransfer &xfer = batch[i];
+
+        // A run of reads becomes one batched transfer when the backend has one
+        size_t end = i;
+        while (end < batch.size() && batch[end].kind == BusTransfer::Kind::Read)
+            end++;
+        if (backend_.readBatch != nullptr && end - i > 1) {
+            reads.clear();
+            for (size_t j = i; j < end; j++)
+                reads.push_back({batch[j].addr, batch[j].reg, batch[j].buf, batch[j].len, 0});
+            backend_.readBatch(backend_.bus, reads.data(), (uint32_t)reads.size());
+            for (size_t j = i; j < end; j++)
+                complete(batch[j], reads[j - i].result);
+            i = end;
+            continue;
+        }
+
+        uint8_t result;
+        switch (xfer.kind) {
+        case BusTransfer::Kind::Read:
+            result = backend_.read(backend_.bus, xfer.addr, xfer.reg, xfer.buf, xfer.len);
+            break;
+        case BusTransfer::Kind::Write:
+            result = backend_.write(backend_.bus, xfer.addr, xfer.reg, xfer.buf, xfer.len);
+            break;
+        case BusTransfer::Kind::Init:
+            result = backend_.init(backend_.bus);
+            break;
+        default:
+            result = backend_.deinit(backend_.bus);
+            break;
+        }
+        complete(xfer, result);
+        i++;
+    }
+}
+
+void BusWorker::complete(const BusTransfer &xfer, uint8_t result) {
+    transfers_.fetch_add(1, std::memory_order_relaxed);
+    if (xfer.callback != nullptr)
+        xfer.callback(xfer.ctx, xfer, result);
+    else if (!completions_.push({xfer.tag, result}))
+        overflows_.fetch_add(1, std::memory_order_relaxed);
+}
+
+namespace {
+    // Rendezvous for one blocking transfer, lives on the caller's stack
+    struct SyncWait {
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        bool done = false;
+        uint8_t result = 1;
+    };
+}
+
+uint8_t BusWorker::transferSync(BusTransfer::Kind kind, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len) {
+    SyncWait wait;
+    BusTransfer xfer{kind, addr, reg, buf, len, 0, nullptr, &wait};
+
+    xfer.callback = [](void *ctx, const BusTransfer &, uint8_t result) {
+        SyncWait *w = static_cast<SyncWait *>(ctx);
+        std::lock_guard<std::mutex> lock(w->mutex);
+        w->result = result;
+        w->done = true;
+        w->done_cv.notify_one();
+    };
+
+    // A full queue drains within one bus batch; wait for room
+    while (!submit(xfer))
+        std::this_thread::yield();
+
+    std::unique_lock<std::mutex> lock(wait.mutex);
+    wait.done_cv.wait(lock, [&wait] { return wait.done; });
+    return wait.result;
+}
+
+uint8_t BusWorker::iicInit(void *worker) {
+    return static_cast<BusWorker *>(worker)->transferSync(BusTransfer::Kind::Init, 0, 0, nullptr, 0);
+}
+
+uint8_t BusWorker::iicDeinit(void *worker) {
+    return static_cast<BusWorker *>(worker)->transferSync(BusTransfer::Kind::Deinit, 0, 0, nullptr, 0);
+}
+
+uint8_t BusWorker::iicRead(void *worker, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len) {
+    return static_cast<BusWorker *>(worker)->transferSync(BusTransfer::Kind::Read, addr, reg, buf, len);
+}
+
+uint8_t BusWorker::iicWrite(void *worker, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len) {
+    return static_cast<BusWorker *>(worker)->transferSync(BusTransfer::Kind::Write, addr, reg, buf, len);
+}
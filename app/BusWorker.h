@@ -0,0 +1,194 @@
+#ifndef BUS_WORKER_H
+#define BUS_WORKER_H
+
+    #include <atomic>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstdint>
+    #include <future>
+    #include <memory>
+    #include <mutex>
+    #include <thread>
+    #include <vector>
+    #include "driver_bmp280_interface.h"
+
+    // Bounded lock-free multi-producer/multi-consumer queue (Vyukov). Each
+    // cell carries a sequence number that tells producers and consumers
+    // whether it is free for their lap, so push and pop are one CAS on the
+    // shared index plus a store to the cell. Capacity is rounded up to a
+    // power of two.
+    template <typename T>
+    class BoundedQueue {
+    public:
+        explicit BoundedQueue(size_t capacity) : mask_(roundUp(capacity) - 1), cells_(new Cell[mask_ + 1]) {
+            for (size_t i = 0; i <= mask_; i++)
+                cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        // False when the queue is full.
+        bool push(const T &value) {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell &cell = cells_[pos & mask_];
+                size_t seq = cell.seq.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+            Cell &cell = cells_[pos & mask_];
+            cell.value = value;
+            cell.seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // False when the queue is empty.
+        bool pop(T &value) {
+            size_t pos = head_.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell &cell = cells_[pos & mask_];
+                size_t seq = cell.seq.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+                if (diff == 0) {
+                    if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = head_.load(std::memory_order_relaxed);
+                }
+            }
+            Cell &cell = cells_[pos & mask_];
+            value = cell.value;
+            cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> seq;
+            T value;
+        };
+
+        static size_t roundUp(size_t n) {
+            size_t p = 2;
+            while (p < n)
+                p <<= 1;
+            return p;
+        }
+
+        const size_t mask_;
+        std::unique_ptr<Cell[]> cells_;
+        alignas(64) std::atomic<size_t> tail_{0};
+        alignas(64) std::atomic<size_t> head_{0};
+    };
+
+    // Transfer descriptor. The buffer belongs to the submitter and must stay
+    // valid until the transfer completes.
+    struct BusTransfer {
+        enum class Kind : uint8_t { Read, Write, Init, Deinit };
+
+        Kind kind;
+        uint8_t addr;
+        uint8_t reg;
+        uint8_t *buf;
+        uint16_t len;
+        uint64_t tag;                                   // returned untouched in the completion
+        void (*callback)(void *ctx, const BusTransfer &xfer, uint8_t result);  // optional, runs on the worker
+        void *ctx;
+    };
+
+    // Result posted for a transfer without a callback.
+    struct BusCompletion {
+        uint64_t tag;
+        uint8_t result;                                 // interface status code
+    };
+
+    // The I2C backend a worker drives: any bus context with the interface
+    // callback signatures (adapter, simulator, recorder). readBatch is
+    // optional; without it consecutive reads still go out back to back, one
+    // call each.
+    struct BusBackend {
+        void *bus;
+        uint8_t (*init)(void *bus);
+        uint8_t (*deinit)(void *bus);
+        uint8_t (*read)(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+        uint8_t (*write)(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+        uint8_t (*readBatch)(void *bus, bmp280_interface_iic_read_t *reads, uint32_t count);
+    };
+
+    // Single owner thread for one adapter.
+    //
+    // Sensors submit transfer descriptors from any thread into a lock-free
+    // queue and never touch the bus themselves. The worker drains everything
+    // that is pending, issues it back to back — runs of reads as one batched
+    // I2C_RDWR where the backend allows — and then reports each result
+    // through the descriptor's callback, or through the completion queue
+    // for poll(). Submission order is kept per adapter.
+    //
+    // The static iic* functions give the driver a blocking view of the
+    // worker: link a handle with bus = the worker and every register access
+    // becomes a submission that waits for its completion, so several
+    // handles on the same adapter share it safely from their own threads.
+    class BusWorker {
+    public:
+        explicit BusWorker(const BusBackend &backend, size_t depth = 256);
+        ~BusWorker();
+
+        BusWorker(const BusWorker &) = delete;
+        BusWorker &operator=(const BusWorker &) = delete;
+
+        // Queue a transfer. False when the submission queue is full.
+        bool submit(const BusTransfer &xfer);
+
+        // Queue a transfer and wait on the returned future for its status.
+        std::future<uint8_t> submitFuture(BusTransfer xfer);
+
+        // Collect up to max completions of callback-less transfers.
+        size_t poll(BusCompletion *out, size_t max);
+
+        uint64_t transfers() const { return transfers_.load(std::memory_order_relaxed); }
+        uint64_t batches() const { return batches_.load(std::memory_order_relaxed); }   // worker wake-ups with work
+        uint64_t overflows() const { return overflows_.load(std::memory_order_relaxed); }  // completions dropped, queue full
+
+        // The worker thread, for scheduling settings: a real-time caller
+        // blocks on it, so it must run at the caller's priority.
+        std::thread::native_handle_type nativeHandle() { return thread_.native_handle(); }
+
+        // Interface-compatible blocking callbacks, bus = BusWorker *. Init
+        // and deinit run on the worker too, so the backend is only ever
+        // touched from one thread. Must not be called from a callback.
+        static uint8_t iicInit(void *worker);
+        static uint8_t iicDeinit(void *worker);
+        static uint8_t iicRead(void *worker, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+        static uint8_t iicWrite(void *worker, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+    private:
+        void run();
+        void execute(std::vector<BusTransfer> &batch);
+        void complete(const BusTransfer &xfer, uint8_t result);
+        uint8_t transferSync(BusTransfer::Kind kind, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+        BusBackend backend_;
+        BoundedQueue<BusTransfer> submissions_;
+        BoundedQueue<BusCompletion> completions_;
+
+        // Sleep/wake: the lock is only taken when the worker has run dry
+        std::atomic<int64_t> pending_{0};               // submitted minus taken, may dip below zero
+        std::atomic<bool> sleeping_{false};
+        std::atomic<bool> stop_{false};
+        std::mutex mutex_;
+        std::condition_variable wake_;
+
+        std::atomic<uint64_t> transfers_{0};
+        std::atomic<uint64_t> batches_{0};
+        std::atomic<uint64_t> overflows_{0};
+        std::thread thread_;
+    };
+
+#endif
@@ -0,0 +1,83 @@
+#include "Clock.h"
+
+#include <cerrno>
+#include <time.h>
+
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+static Clock *gs_driver_clock = &Clock::system();
+
+Clock &Clock::system()
+{
+    static SystemClock clock;
+    return clock;
+}
+
+Clock::time_point SystemClock::now()
+{
+    return steady_clock::now();
+}
+
+bool SystemClock::sleepUntil(time_point t)
+{
+    // steady_clock counts CLOCK_MONOTONIC, so its epoch offset is the
+    // absolute deadline clock_nanosleep expects
+    nanoseconds since_epoch = t.time_since_epoch();
+    struct timespec ts;
+    ts.tv_sec = time_t(since_epoch.count() / 1000000000);
+    ts.tv_nsec = long(since_epoch.count() % 1000000000);
+    return clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) != EINTR;
+}
+
+VirtualClock::VirtualClock(time_point start)
+    : now_ns_(nanoseconds(start.time_since_epoch()).count()), sleeps_(0)
+{
+}
+
+Clock::time_point VirtualClock::now()
+{
+    return time_point(nanoseconds(now_ns_.load(std::memory_order_relaxed)));
+}
+
+bool VirtualClock::sleepUntil(time_point t)
+{
+    int64_t target = nanoseconds(t.time_since_epoch()).count();
+    int64_t current = now_ns_.load(std::memory_order_relaxed);
+    while (current < target && !now_ns_.compare_exchange_weak(current, target, std::memory_order_relaxed))
+        ;
+    sleeps_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void VirtualClock::advance(nanoseconds d)
+{
+    now_ns_.fetch_add(d.count(), std::memory_order_relaxed);
+}
+
+void bindDriverClock(Clock &clock)
+{
+    gs_driver_clock = &clock;
+}
+
+void clockDelayMs(uint32_t ms)
+{
+    gs_driver_clock->sleepFor(std::chrono::milliseconds(ms));
+}
+
+void clockDelayUs(uint32_t us)
+{
+    gs_driver_clock->sleepFor(microseconds(us));
+}
+
+uint64_t clockNowUs(void *clock)
+{
+    Clock::time_point now = static_cast<Clock *>(clock)->now();
+    return uint64_t(std::chrono::duration_cast<microseconds>(now.time_since_epoch()).count());
+}
+
+void clockSleepUs(void *clock, uint64_t us)
+{
+    static_cast<Clock *>(clock)->sleepFor(microseconds(us));
+}
@@ -0,0 +1,68 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+    #include <atomic>
+    #include <chrono>
+    #include <cstdint>
+
+    // Time source and sleep for everything that paces acquisition.
+    //
+    // Time points are steady_clock ones, so readings, schedulers and
+    // histograms look the same whichever clock drove them.
+    class Clock {
+    public:
+        using time_point = std::chrono::steady_clock::time_point;
+
+        virtual ~Clock() {}
+
+        virtual time_point now() = 0;
+
+        // Sleep until t. Returns false if a signal cut the sleep short.
+        virtual bool sleepUntil(time_point t) = 0;
+
+        bool sleepFor(std::chrono::nanoseconds d) { return sleepUntil(now() + d); }
+
+        // CLOCK_MONOTONIC and clock_nanosleep.
+        static Clock &system();
+    };
+
+    class SystemClock : public Clock {
+    public:
+        time_point now() override;
+        bool sleepUntil(time_point t) override;
+    };
+
+    // Discrete virtual time for single-threaded runs against the simulator
+    // or an unpaced trace replay.
+    //
+    // A sleep returns at once and moves the clock to its deadline, so time
+    // only passes when the code under test waits, and a run is a pure
+    // function of its inputs: a day of acquisition takes as long as the CPU
+    // work in it. Threads that sleep concurrently (bus worker, timer wheel)
+    // are not coordinated and stay on the system clock; a TimerWheel
+    // without threads is polled instead.
+    class VirtualClock : public Clock {
+    public:
+        explicit VirtualClock(time_point start = std::chrono::steady_clock::now());
+
+        time_point now() override;
+        bool sleepUntil(time_point t) override;
+
+        void advance(std::chrono::nanoseconds d);
+        uint64_t sleeps() const { return sleeps_.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<int64_t> now_ns_;      // since the steady_clock epoch
+        std::atomic<uint64_t> sleeps_;
+    };
+
+    // The driver's delay hooks and the simulator's time hooks take no clock
+    // argument of their own, or a void *; these adapt them to a Clock.
+    // bindDriverClock() selects the clock behind clockDelayMs/Us.
+    void bindDriverClock(Clock &clock);
+    void clockDelayMs(uint32_t ms);
+    void clockDelayUs(uint32_t us);
+    uint64_t clockNowUs(void *clock);
+    void clockSleepUs(void *clock, uint64_t us);
+
+#endif
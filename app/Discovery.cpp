@@ -0,0 +1,123 @@
+#include "Discovery.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <fcntl.h>
+#include <future>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+// The driver interface logs every failed transfer; a probe expects most
+// addresses to NACK, so it talks to i2c-dev directly and stays quiet.
+static bool readRegisters(int fd, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    struct i2c_msg msgs[2];
+    msgs[0].addr = addr;
+    msgs[0].flags = 0;
+    msgs[0].len = 1;
+    msgs[0].buf = &reg;
+    msgs[1].addr = addr;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = len;
+    msgs[1].buf = buf;
+
+    struct i2c_rdwr_ioctl_data xfer;
+    xfer.msgs = msgs;
+    xfer.nmsgs = 2;
+    return ioctl(fd, I2C_RDWR, &xfer) == 2;
+}
+
+static BMP280ChipType classify(uint8_t chip_id)
+{
+    switch (chip_id) {
+    case 0x58:
+        return BMP280ChipType::BMP280;
+    case 0x56:
+    case 0x57:
+        return BMP280ChipType::BMP280Sample;
+    case 0x60:
+        return BMP280ChipType::BME280;
+    default:
+        return BMP280ChipType::Other;
+    }
+}
+
+static uint32_t fingerprint(const uint8_t *buf, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= buf[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static std::vector<BMP280Device> probeAdapter(const std::string &bus, const std::vector<uint8_t> &addresses)
+{
+    std::vector<BMP280Device> found;
+    int fd = open(bus.c_str(), O_RDWR);
+    if (fd < 0)
+        return found;
+
+    for (uint8_t addr : addresses) {
+        uint8_t id;
+        if (!readRegisters(fd, addr, 0xD0, &id, 1))
+            continue;
+
+        BMP280Device dev{bus, addr, id, classify(id), 0};
+        uint8_t calib[24];
+        if (dev.type != BMP280ChipType::Other && readRegisters(fd, addr, 0x88, calib, sizeof(calib)))
+            dev.fingerprint = fingerprint(calib, sizeof(calib));
+        found.push_back(dev);
+    }
+
+    close(fd);
+    return found;
+}
+
+std::vector<std::string> listI2CAdapters()
+{
+    std::vector<std::string> adapters;
+    DIR *dir = opendir("/dev");
+    if (dir == nullptr)
+        return adapters;
+    while (struct dirent *entry = readdir(dir)) {
+        if (std::string(entry->d_name).rfind("i2c-", 0) == 0)
+            adapters.push_back(std::string("/dev/") + entry->d_name);
+    }
+    closedir(dir);
+    std::sort(adapters.begin(), adapters.end());
+    return adapters;
+}
+
+std::vector<BMP280Device> discoverBMP280(const std::vector<uint8_t> &addresses)
+{
+    // Adapters are independent buses, so a slow or hung one only costs its
+    // own thread; the total time is that of the slowest adapter
+    std::vector<std::future<std::vector<BMP280Device>>> probes;
+    for (const std::string &bus : listI2CAdapters())
+        probes.push_back(std::async(std::launch::async, probeAdapter, bus, addresses));
+
+    std::vector<BMP280Device> devices;
+    for (auto &probe : probes) {
+        std::vector<BMP280Device> found = probe.get();
+        devices.insert(devices.end(), found.begin(), found.end());
+    }
+    return devices;
+}
+
+const char *chipTypeName(BMP280ChipType type)
+{
+    switch (type) {
+    case BMP280ChipType::BMP280:
+        return "BMP280";
+    case BMP280ChipType::BMP280Sample:
+        return "BMP280 (sample)";
+    case BMP280ChipType::BME280:
+        return "BME280";
+    default:
+        return "other";
+    }
+}
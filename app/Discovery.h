@@ -0,0 +1,38 @@
+#ifndef DISCOVERY_H
+#define DISCOVERY_H
+
+    #include <cstdint>
+    #include <string>
+    #include <vector>
+
+    // Bosch chip ID at register 0xD0.
+    enum class BMP280ChipType {
+        BMP280,        // 0x58, production part
+        BMP280Sample,  // 0x56 / 0x57, engineering samples
+        BME280,        // 0x60, same calibration layout plus humidity
+        Other,         // something else answered at the address
+    };
+
+    // One device that answered the chip-ID probe.
+    struct BMP280Device {
+        std::string bus;         // adapter path, e.g. /dev/i2c-1
+        uint8_t addr;
+        uint8_t chip_id;
+        BMP280ChipType type;
+        uint32_t fingerprint;    // FNV-1a of the 24 calibration bytes, 0 for Other
+    };
+
+    // I2C adapters present on the system, sorted by path.
+    std::vector<std::string> listI2CAdapters();
+
+    // Probe every adapter in parallel, one thread per adapter. Each
+    // candidate address costs a single one-byte chip-ID read; only devices
+    // that return a Bosch ID get a second burst for the calibration
+    // fingerprint. Nothing is written, so the probe never disturbs a sensor
+    // that is already running. Results follow the adapter order, then the
+    // order of addresses.
+    std::vector<BMP280Device> discoverBMP280(const std::vector<uint8_t> &addresses = {0x76, 0x77});
+
+    const char *chipTypeName(BMP280ChipType type);
+
+#endif
@@ -0,0 +1,56 @@
+#include "ForcedSampler.h"
+
+BMP280ForcedSampler::BMP280ForcedSampler(bmp280_handle_t *handle, Clock &clock)
+    : handle_(handle), clock_(clock), measure_us_(0), in_flight_(false)
+{
+}
+
+uint8_t BMP280ForcedSampler::start()
+{
+    in_flight_ = false;
+    return bmp280_get_measure_time_us(handle_, &measure_us_);
+}
+
+uint8_t BMP280ForcedSampler::trigger()
+{
+    // CTRL_MEAS comes from the driver's shadow, so this is a single write
+    uint8_t res = bmp280_set_mode(handle_, BMP280_MODE_FORCED);
+    if (res != 0)
+        return res;
+
+    triggered_ = clock_.now();
+    in_flight_ = true;
+    return 0;
+}
+
+uint8_t BMP280ForcedSampler::collect(BMP280Reading &reading)
+{
+    uint8_t res;
+    bmp280_sample_t sample;
+
+    if (!in_flight_)
+    {
+        res = trigger();
+        if (res != 0)
+            return res;
+    }
+    in_flight_ = false;
+
+    // Only the part of the conversion that has not already elapsed is waited out
+    clock_.sleepUntil(triggered_ + std::chrono::microseconds(measure_us_));
+    res = bmp280_read_sample(handle_, &sample);
+    if (res == 0 && (sample.measuring || sample.mode != BMP280_MODE_SLEEP))
+    {
+        // Slower than the datasheet maximum; give it one more conversion time
+        clock_.sleepFor(std::chrono::microseconds(measure_us_));
+        res = bmp280_read_sample(handle_, &sample);
+        if (res == 0 && (sample.measuring || sample.mode != BMP280_MODE_SLEEP))
+            res = 5;
+    }
+    if (res != 0)
+        return res;
+
+    reading.triggered = triggered_;
+    reading.completed = clock_.now();
+    return compensateReading(handle_, sample, reading);
+}
@@ -0,0 +1,52 @@
+#ifndef FORCED_SAMPLER_H
+#define FORCED_SAMPLER_H
+
+    #include <chrono>
+    #include <cstdint>
+    #include "driver_bmp280.h"
+    #include "Clock.h"
+    #include "Reading.h"
+
+    // Forced-mode sampler with a split trigger and collect.
+    //
+    // trigger() starts a conversion and collect() waits out whatever is left
+    // of its datasheet conversion time and reads it with one burst, so every
+    // sample costs exactly one conversion: one trigger write and one burst
+    // read. The conversion stays in flight between the two calls, which lets
+    // the caller choose when it runs:
+    //
+    //  - on a paced schedule, wake measureTimeUs() before the deadline
+    //    (PeriodicScheduler::setLead), trigger, and collect at the deadline
+    //    in the same tick; the reading is no older than its deadline, but
+    //    the conversion does not overlap anything else;
+    //  - back to back, trigger sample N+1 right after collecting sample N, so
+    //    it converts while sample N is printed or stored. Only this mode
+    //    pipelines.
+    class BMP280ForcedSampler {
+    public:
+        explicit BMP280ForcedSampler(bmp280_handle_t *handle, Clock &clock = Clock::system());
+
+        // Look up the conversion time for the current oversampling and drop
+        // any conversion in flight. Returns a driver status code.
+        uint8_t start();
+
+        // Start a conversion now. Returns a driver status code.
+        uint8_t trigger();
+
+        // Wait for the conversion in flight, triggering one first if there
+        // is none, and return the compensated result. Returns a driver
+        // status code; nothing is in flight afterwards either way.
+        uint8_t collect(BMP280Reading &reading);
+
+        // Predicted conversion time for the current oversampling.
+        uint32_t measureTimeUs() const { return measure_us_; }
+
+    private:
+        bmp280_handle_t *handle_;
+        Clock &clock_;
+        uint32_t measure_us_;
+        bool in_flight_;
+        std::chrono::steady_clock::time_point triggered_;
+    };
+
+#endif
@@ -0,0 +1,107 @@
+#include "PeriodicScheduler.h"
+
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+void LatencyHistogram::reset()
+{
+    for (int i = 0; i < kBuckets; i++)
+        buckets_[i] = 0;
+    count_ = 0;
+    min_ns_ = 0;
+    max_ns_ = 0;
+    sum_ns_ = 0;
+}
+
+void LatencyHistogram::add(nanoseconds latency)
+{
+    int64_t ns = latency.count() < 0 ? 0 : latency.count();
+    uint64_t us = uint64_t(ns / 1000);
+    int i = 0;
+    while (us != 0 && i < kBuckets - 1)
+    {
+        us >>= 1;
+        i++;
+    }
+    buckets_[i]++;
+    if (count_ == 0 || ns < min_ns_)
+        min_ns_ = ns;
+    if (ns > max_ns_)
+        max_ns_ = ns;
+    sum_ns_ += ns;
+    count_++;
+}
+
+void LatencyHistogram::print(std::ostream &out) const
+{
+    for (int i = 0; i < kBuckets; i++)
+    {
+        if (buckets_[i] == 0)
+            continue;
+        if (i == 0)
+            out << "  <1 us";
+        else if (i == kBuckets - 1)
+            out << "  >=" << (1ull << (i - 1)) << " us";
+        else
+            out << "  " << (1ull << (i - 1)) << "-" << (1ull << i) << " us";
+        out << ": " << buckets_[i] << "\n";
+    }
+    out << "  min " << min().count() / 1000.0 << " us, mean " << mean().count() / 1000.0
+        << " us, max " << max().count() / 1000.0 << " us\n";
+}
+
+PeriodicScheduler::PeriodicScheduler(nanoseconds period, Clock &clock)
+    : clock_(clock), period_(period), lead_(0), index_(0), overruns_(0), skipped_(0)
+{
+    start();
+}
+
+void PeriodicScheduler::start()
+{
+    start_ = clock_.now();
+    index_ = 0;
+}
+
+bool PeriodicScheduler::wait(SchedulerTick &tick)
+{
+    steady_clock::time_point now = clock_.now();
+    uint64_t lost = 0;
+
+    if (period_.count() == 0)
+    {
+        tick.index = ++index_;
+        tick.deadline = now;
+        tick.woke = now;
+        tick.skipped = 0;
+        return true;
+    }
+
+    steady_clock::time_point deadline = start_ + period_ * (index_ + 1) - lead_;
+    if (now >= deadline + period_)
+    {
+        // Overrun: run the latest deadline that has passed, late, and drop
+        // the ones before it
+        lost = uint64_t((now - deadline) / period_);
+        index_ += lost;
+        deadline += period_ * lost;
+        overruns_++;
+        skipped_ += lost;
+    }
+    else if (now < deadline && !clock_.sleepUntil(deadline))
+        return false;
+
+    tick.woke = clock_.now();
+    tick.deadline = deadline;
+    tick.index = ++index_;
+    tick.skipped = lost;
+    latency_.add(tick.woke - deadline);
+    return true;
+}
+
+void PeriodicScheduler::report(std::ostream &out) const
+{
+    out << index_ << " periods of " << period_.count() / 1000 << " us, " << overruns_ << " overruns, "
+        << skipped_ << " periods skipped\n";
+    out << "Wake-up latency:\n";
+    latency_.print(out);
+}
@@ -0,0 +1,103 @@
+#ifndef PERIODIC_SCHEDULER_H
+#define PERIODIC_SCHEDULER_H
+
+    #include <chrono>
+    #include <cstdint>
+    #include <ostream>
+    #include "Clock.h"
+
+    // Log2 histogram of how late each wake-up was, in microseconds: bucket
+    // 0 holds < 1 us, bucket i holds [2^(i-1), 2^i) us and the last bucket
+    // everything beyond.
+    class LatencyHistogram {
+    public:
+        static const int kBuckets = 24;
+
+        LatencyHistogram() { reset(); }
+
+        void reset();
+        void add(std::chrono::nanoseconds latency);
+
+        uint64_t count() const { return count_; }
+        std::chrono::nanoseconds min() const { return std::chrono::nanoseconds(count_ ? min_ns_ : 0); }
+        std::chrono::nanoseconds max() const { return std::chrono::nanoseconds(max_ns_); }
+        std::chrono::nanoseconds mean() const { return std::chrono::nanoseconds(count_ ? int64_t(sum_ns_ / count_) : 0); }
+        uint64_t bucket(int i) const { return buckets_[i]; }
+
+        // One line per non-empty bucket plus a min/mean/max summary.
+        void print(std::ostream &out) const;
+
+    private:
+        uint64_t buckets_[kBuckets];
+        uint64_t count_;
+        int64_t min_ns_;
+        int64_t max_ns_;
+        long double sum_ns_;
+    };
+
+    // One release of the periodic schedule.
+    struct SchedulerTick {
+        uint64_t index;                                    // period number since start()
+        std::chrono::steady_clock::time_point deadline;    // when it should have run, lead included
+        std::chrono::steady_clock::time_point woke;        // when the sleep actually returned
+        uint64_t skipped;                                  // whole periods lost to an overrun before it
+    };
+
+    // Drift-free periodic release on absolute CLOCK_MONOTONIC deadlines.
+    //
+    // Deadline k is start + k * period, computed from the start rather than
+    // from the previous wake-up, and slept for with clock_nanosleep
+    // TIMER_ABSTIME. Time spent on the bus or printing therefore never
+    // accumulates: a late wake-up is absorbed by the next sleep instead of
+    // shifting every sample after it.
+    //
+    // An overrun is a wake-up that finds one or more later deadlines already
+    // past. Those periods are skipped rather than run back to back, so the
+    // series stays on the original grid with gaps the caller can see in
+    // SchedulerTick::skipped.
+    //
+    // steady_clock is CLOCK_MONOTONIC on Linux, so deadlines compare directly
+    // with the steady_clock stamps in BMP280Reading. A zero period never
+    // sleeps, for replays that run as fast as possible. Time and sleeps come
+    // from the given clock, so a virtual one runs the schedule instantly.
+    //
+    // A lead releases every tick that much before its grid point, so work
+    // that has to be started ahead of the deadline (a forced conversion) is
+    // done by the time the grid point comes round. Deadlines and latencies
+    // are then measured against the early release.
+    class PeriodicScheduler {
+    public:
+        explicit PeriodicScheduler(std::chrono::nanoseconds period, Clock &clock = Clock::system());
+
+        // Anchor the grid; the first deadline is one period from now.
+        void start();
+
+        // Release each tick this much before its grid point; ignored with a
+        // zero period.
+        void setLead(std::chrono::nanoseconds lead) { lead_ = lead; }
+
+        // Sleep until the next deadline. Returns false if a signal
+        // interrupted the sleep; calling again resumes the same deadline.
+        bool wait(SchedulerTick &tick);
+
+        std::chrono::nanoseconds period() const { return period_; }
+        std::chrono::nanoseconds lead() const { return lead_; }
+        uint64_t overruns() const { return overruns_; }        // wake-ups that had to skip
+        uint64_t skipped() const { return skipped_; }          // periods skipped in total
+        const LatencyHistogram &latency() const { return latency_; }
+
+        // Tick count, overruns and the wake-up latency histogram.
+        void report(std::ostream &out) const;
+
+    private:
+        Clock &clock_;
+        std::chrono::nanoseconds period_;
+        std::chrono::nanoseconds lead_;
+        std::chrono::steady_clock::time_point start_;
+        uint64_t index_;
+        uint64_t overruns_;
+        uint64_t skipped_;
+        LatencyHistogram latency_;
+    };
+
+#endif
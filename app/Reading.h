@@ -0,0 +1,41 @@
+#ifndef READING_H
+#define READING_H
+
+    #include <chrono>
+    #include <cstdint>
+    #include "driver_bmp280.h"
+
+    // One compensated BMP280 measurement.
+    //
+    // Built with BMP280_FIXED_POINT the integer fields are filled and the
+    // float fields stay zero, so acquisition never touches the FPU;
+    // otherwise it is the other way round.
+    struct BMP280Reading {
+        std::chrono::steady_clock::time_point triggered; // when the conversion started
+        std::chrono::steady_clock::time_point completed; // when its data had been read
+        uint32_t temperature_raw;
+        uint32_t pressure_raw;
+        float temperature_c;
+        float pressure_pa;
+        int32_t temperature_centi_c;                      // 0.01 degC
+        uint32_t pressure_q24_8;                          // Pa with 8 fractional bits
+    };
+
+    // Fill the compensated fields of a reading from a burst-read sample.
+    // Returns a driver status code.
+    inline uint8_t compensateReading(bmp280_handle_t *handle, const bmp280_sample_t &sample, BMP280Reading &reading)
+    {
+        reading.temperature_raw = sample.temperature_raw;
+        reading.pressure_raw = sample.pressure_raw;
+        reading.temperature_c = 0;
+        reading.pressure_pa = 0;
+        reading.temperature_centi_c = 0;
+        reading.pressure_q24_8 = 0;
+    #ifdef BMP280_FIXED_POINT
+        return bmp280_compensate_sample_fixed(handle, &sample, &reading.temperature_centi_c, &reading.pressure_q24_8);
+    #else
+        return bmp280_compensate_sample(handle, &sample, &reading.temperature_c, &reading.pressure_pa);
+    #endif
+    }
+
+#endif
@@ -0,0 +1,157 @@
+#include "Realtime.h"
+
+#include <alloca.h>
+#include <cerrno>
+#include <cstring>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static void appendError(std::string &error, const char *what, int err)
+{
+    if (!error.empty())
+        error += "; ";
+    error += what;
+    error += ": ";
+    error += std::strerror(err);
+}
+
+void prefault(void *buf, size_t len)
+{
+    volatile unsigned char *p = static_cast<volatile unsigned char *>(buf);
+    size_t page = size_t(sysconf(_SC_PAGESIZE));
+
+    for (size_t i = 0; i < len; i += page)
+        p[i] = p[i];
+}
+
+// Kept out of line so the alloca'd block sits below enterRealtime's frame,
+// where the acquisition loop's deeper calls will run
+__attribute__((noinline)) static void prefaultStack(size_t bytes)
+{
+    void *stack = alloca(bytes);
+    std::memset(stack, 0, bytes);
+    asm volatile("" : : "r"(stack) : "memory");
+}
+
+bool enterRealtime(const RealtimeConfig &config, std::string &error)
+{
+    error.clear();
+
+    if (config.lockMemory)
+    {
+        // Freed memory stays in the heap, and large blocks come from the
+        // locked heap instead of new mappings
+        mallopt(M_TRIM_THRESHOLD, -1);
+        mallopt(M_MMAP_MAX, 0);
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+            appendError(error, "mlockall", errno);
+    }
+    if (config.stackBytes != 0)
+        prefaultStack(config.stackBytes);
+
+    std::string thread_error;
+    if (!applyRealtime(pthread_self(), config, thread_error))
+        error += (error.empty() ? "" : "; ") + thread_error;
+    return error.empty();
+}
+
+bool applyRealtime(pthread_t thread, const RealtimeConfig &config, std::string &error)
+{
+    error.clear();
+
+    if (config.cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(config.cpu, &set);
+        int err = pthread_setaffinity_np(thread, sizeof(set), &set);
+        if (err != 0)
+            appendError(error, "CPU affinity", err);
+    }
+
+    if (config.priority > 0)
+    {
+        struct sched_param param = {};
+        param.sched_priority = config.priority;
+        int err = pthread_setschedparam(thread, SCHED_FIFO, &param);
+        if (err != 0)
+            appendError(error, "SCHED_FIFO", err);
+    }
+    return error.empty();
+}
+
+bool LatencyLog::open(const char *path)
+{
+    close();
+    if (path != nullptr)
+    {
+        file_ = std::fopen(path, "w");
+        if (file_ == nullptr)
+            return false;
+        std::setvbuf(file_, buffer_, _IOFBF, sizeof(buffer_));
+        std::fputs("period,deadline_ns,woke_ns,latency_ns,skipped\n", file_);
+    }
+    writing_.store(true, std::memory_order_release);
+    thread_ = std::thread(&LatencyLog::run, this);
+    return true;
+}
+
+void LatencyLog::record(const SchedulerTick &tick)
+{
+    if (writing_.load(std::memory_order_relaxed) && (file_ != nullptr || tick.skipped != 0))
+        ring_.push(Entry{tick, 0});
+}
+
+void LatencyLog::recordError(uint8_t code)
+{
+    if (writing_.load(std::memory_order_relaxed))
+        ring_.push(Entry{SchedulerTick(), code});
+}
+
+void LatencyLog::run()
+{
+    Entry entry;
+
+    for (;;)
+    {
+        bool last = !writing_.load(std::memory_order_acquire);
+        while (ring_.pop(entry))
+        {
+            const SchedulerTick &tick = entry.tick;
+            if (entry.error != 0)
+            {
+                std::fprintf(stderr, "Failed to read BMP280! Error code: %d\n", int(entry.error));
+                continue;
+            }
+            if (tick.skipped != 0)
+                std::fprintf(stderr, "Overrun: skipped %llu periods before period %llu\n",
+                             (unsigned long long)tick.skipped, (unsigned long long)tick.index);
+            if (file_ == nullptr)
+                continue;
+            long long deadline = (long long)std::chrono::nanoseconds(tick.deadline.time_since_epoch()).count();
+            long long woke = (long long)std::chrono::nanoseconds(tick.woke.time_since_epoch()).count();
+            std::fprintf(file_, "%llu,%lld,%lld,%lld,%llu\n", (unsigned long long)tick.index, deadline, woke,
+                         woke - deadline, (unsigned long long)tick.skipped);
+        }
+        if (last)
+            return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+void LatencyLog::close()
+{
+    if (thread_.joinable())
+    {
+        writing_.store(false, std::memory_order_release);
+        thread_.join();
+    }
+    if (file_ != nullptr)
+    {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
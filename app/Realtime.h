@@ -0,0 +1,92 @@
+#ifndef REALTIME_H
+#define REALTIME_H
+
+    #include <atomic>
+    #include <cstddef>
+    #include <cstdio>
+    #include <pthread.h>
+    #include <string>
+    #include <thread>
+    #include "PeriodicScheduler.h"
+    #include "SpscRing.h"
+
+    // Settings for the acquisition thread's real-time mode.
+    struct RealtimeConfig {
+        int cpu = -1;                      // core to pin to, -1 leaves the affinity alone
+        int priority = 0;                  // SCHED_FIFO priority 1..99, 0 stays SCHED_OTHER
+        bool lockMemory = true;            // mlockall current and future pages
+        size_t stackBytes = 256 * 1024;    // stack to prefault below the caller
+    };
+
+    // Put the calling thread into real-time mode.
+    //
+    // Memory is locked and the heap told never to give pages back or to
+    // serve allocations from fresh mmaps, so a buffer that has been touched
+    // once never page-faults again. The stack is prefaulted here; call
+    // prefault() on buffers allocated before. The thread is then pinned and
+    // switched to SCHED_FIFO. Each step that fails is described in error and
+    // the others are still applied; returns true if all succeeded.
+    //
+    // SCHED_FIFO and mlockall need root or CAP_SYS_NICE / CAP_IPC_LOCK
+    // (or matching rtprio and memlock limits).
+    bool enterRealtime(const RealtimeConfig &config, std::string &error);
+
+    // Pin another thread and switch it to SCHED_FIFO the same way, for a
+    // helper the real-time thread blocks on (the bus worker): left at
+    // SCHED_OTHER it would be preempted by anything while holding up the
+    // acquisition. Memory locking is process-wide and not repeated.
+    bool applyRealtime(pthread_t thread, const RealtimeConfig &config, std::string &error);
+
+    // Write to every page of a buffer so that it is resident.
+    void prefault(void *buf, size_t len);
+
+    // Per-sample wake-up latency export: one CSV line per scheduler period
+    // or stream sample with the deadline, the actual wake-up and their
+    // difference, in nanoseconds on CLOCK_MONOTONIC. Ticks that skipped
+    // periods are also reported on stderr as overruns, and so are failed
+    // samples passed to recordError().
+    //
+    // record() only pushes the tick into an SPSC ring; a writer thread of
+    // its own formats the lines and writes them block-buffered, in 64 KiB
+    // chunks, so the sampling path never enters stdio. Open the log before
+    // enterRealtime() so the writer stays an ordinary thread; opened with a
+    // null path it writes no CSV and only reports overruns and errors. A full ring
+    // drops the newest tick rather than making the sampler wait.
+    class LatencyLog {
+    public:
+        static const size_t kDepth = 1024;
+
+        LatencyLog() : file_(nullptr), ring_(kDepth, OverflowPolicy::DropNewest), writing_(false) {}
+        ~LatencyLog() { close(); }
+
+        LatencyLog(const LatencyLog &) = delete;
+        LatencyLog &operator=(const LatencyLog &) = delete;
+
+        bool open(const char *path);
+        void record(const SchedulerTick &tick);
+
+        // Report a sample that failed with a driver status code.
+        void recordError(uint8_t code);
+
+        // Write what is still queued and close the file.
+        void close();
+
+        uint64_t drops() const { return ring_.drops(); }
+
+    private:
+        // A tick, or a failed sample when error is non-zero
+        struct Entry {
+            SchedulerTick tick;
+            uint8_t error;
+        };
+
+        void run();
+
+        FILE *file_;
+        char buffer_[64 * 1024];
+        SpscRing<Entry> ring_;
+        std::atomic<bool> writing_;
+        std::thread thread_;
+    };
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+    #include <atomic>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <memory>
+    #include <thread>
+    #include <type_traits>
+
+    // What push() does when the ring is full.
+    enum class OverflowPolicy {
+        DropOldest,    // overwrite the oldest record; the producer never waits
+        DropNewest,    // discard the record being pushed
+        Block,         // wait for the consumer to make room
+    };
+
+    // Fixed-capacity lock-free ring for one producer thread and one consumer
+    // thread.
+    //
+    // Each side owns one index on its own cache line and keeps a cached copy
+    // of the other side's, so in the steady state a push or pop touches no
+    // line the other thread writes. Slots are cache-line aligned for the
+    // same reason.
+    //
+    // Every slot is a small seqlock: a sequence number that is odd while the
+    // slot is written and encodes which lap it holds, and the record as
+    // relaxed atomic words. That is what lets DropOldest overwrite a slot the
+    // consumer may be reading at the same moment: the consumer sees the
+    // sequence change, counts the records it was lapped by and resumes at the
+    // oldest one still intact. T must be trivially copyable.
+    template <typename T>
+    class SpscRing {
+        static_assert(std::is_trivially_copyable<T>::value, "SpscRing records are copied as raw words");
+
+    public:
+        explicit SpscRing(size_t capacity, OverflowPolicy policy = OverflowPolicy::DropOldest)
+            : capacity_(capacity ? capacity : 1), policy_(policy), slots_(new Slot[capacity_]) {
+            for (size_t i = 0; i < capacity_; i++)
+                slots_[i].seq.store(0, std::memory_order_relaxed);
+        }
+
+        SpscRing(const SpscRing &) = delete;
+        SpscRing &operator=(const SpscRing &) = delete;
+
+        // Producer side. False only when DropNewest discarded the record.
+        bool push(const T &value) {
+            uint64_t t = producer_.tail.load(std::memory_order_relaxed);
+            if (t - producer_.head_cache >= capacity_) {
+                producer_.head_cache = consumer_.head.load(std::memory_order_acquire);
+                while (t - producer_.head_cache >= capacity_ && policy_ != OverflowPolicy::DropOldest) {
+                    if (policy_ == OverflowPolicy::DropNewest) {
+                        dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    std::this_thread::yield();
+                    producer_.head_cache = consumer_.head.load(std::memory_order_acquire);
+                }
+            }
+
+            Slot &slot = slots_[t % capacity_];
+            uint64_t words[kWords] = {};
+            std::memcpy(words, &value, sizeof(T));
+            slot.seq.store(2 * t + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < kWords; i++)
+                slot.words[i].store(words[i], std::memory_order_relaxed);
+            slot.seq.store(2 * t + 2, std::memory_order_release);
+            producer_.tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side. False when the ring is empty.
+        bool pop(T &value) {
+            uint64_t h = consumer_.head.load(std::memory_order_relaxed);
+            for (;;) {
+                if (h == consumer_.tail_cache) {
+                    consumer_.tail_cache = producer_.tail.load(std::memory_order_acquire);
+                    if (h == consumer_.tail_cache)
+                        return false;
+
+                    // The backlog is largest right when the consumer comes
+                    // back for more, which is when it is measured
+                    uint64_t used = consumer_.tail_cache - h;
+                    if (used > capacity_)
+                        used = capacity_;
+                    if (used > high_water_.load(std::memory_order_relaxed))
+                        high_water_.store(used, std::memory_order_relaxed);
+                }
+
+                Slot &slot = slots_[h % capacity_];
+                uint64_t expected = 2 * h + 2;
+                uint64_t before = slot.seq.load(std::memory_order_acquire);
+                if (before == expected) {
+                    uint64_t words[kWords];
+                    for (size_t i = 0; i < kWords; i++)
+                        words[i] = slot.words[i].load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (slot.seq.load(std::memory_order_relaxed) == expected) {
+                        std::memcpy(&value, words, sizeof(T));
+                        consumer_.head.store(h + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+
+                // Lapped: the producer has moved past this record. Skip to
+                // the oldest slot it cannot be writing right now.
+                uint64_t t = producer_.tail.load(std::memory_order_acquire);
+                uint64_t resume = t > capacity_ ? t - capacity_ + 1 : 0;
+                if (resume <= h)
+                    resume = h + 1;
+                dropped_oldest_.fetch_add(resume - h, std::memory_order_relaxed);
+                h = resume;
+                consumer_.head.store(h, std::memory_order_release);
+                consumer_.tail_cache = t;
+            }
+        }
+
+        size_t capacity() const { return capacity_; }
+        OverflowPolicy policy() const { return policy_; }
+
+        // Records lost to either drop policy.
+        uint64_t drops() const {
+            return dropped_newest_.load(std::memory_order_relaxed) + dropped_oldest_.load(std::memory_order_relaxed);
+        }
+
+        // Most records ever waiting at once, as seen by the consumer.
+        uint64_t highWater() const { return high_water_.load(std::memory_order_relaxed); }
+
+    private:
+        static const size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        struct alignas(64) Slot {
+            std::atomic<uint64_t> seq;
+            std::atomic<uint64_t> words[kWords];
+        };
+
+        struct alignas(64) ProducerSide {
+            std::atomic<uint64_t> tail{0};
+            uint64_t head_cache = 0;
+        };
+
+        struct alignas(64) ConsumerSide {
+            std::atomic<uint64_t> head{0};
+            uint64_t tail_cache = 0;
+        };
+
+        const size_t capacity_;
+        const OverflowPolicy policy_;
+        std::unique_ptr<Slot[]> slots_;
+        ProducerSide producer_;
+        ConsumerSide consumer_;
+        alignas(64) std::atomic<uint64_t> dropped_newest_{0};     // producer's
+        alignas(64) std::atomic<uint64_t> dropped_oldest_{0};     // consumer's
+        std::atomic<uint64_t> high_water_{0};
+    };
+
+#endif
@@ -0,0 +1,249 @@
+#include "StreamReader.h"
+#include <algorithm>
+
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+BMP280StreamReader::BMP280StreamReader(bmp280_handle_t *handle, Clock &clock)
+    : handle_(handle), clock_(clock), period_us_(0), measure_us_(0), guard_(0), lead_(0), period_(0), unmeasured_(0),
+      probe_interval_(1), unprobed_(0), failures_(0), retries_(0), missed_(0), probes_(0),
+      tick_(), tick_missed_(0)
+{
+}
+
+uint8_t BMP280StreamReader::read(bmp280_sample_t &sample)
+{
+    return bmp280_read_sample(handle_, &sample);
+}
+
+uint8_t BMP280StreamReader::measuring(bool &busy)
+{
+    // STATUS alone: phase checks need the measuring bit, not the data
+    uint8_t status = 0;
+    uint8_t res = bmp280_get_status(handle_, &status);
+    busy = res == 0 && (status & BMP280_STATUS_MEASURING) != 0;
+    return res;
+}
+
+uint8_t BMP280StreamReader::start(bmp280_standby_time_t standby)
+{
+    uint8_t res = bmp280_set_standby_time(handle_, standby);
+    if (res != 0)
+        return res;
+    res = bmp280_set_mode(handle_, BMP280_MODE_NORMAL);
+    if (res != 0)
+        return res;
+    res = bmp280_get_normal_period_us(handle_, &period_us_);
+    if (res != 0)
+        return res;
+    res = bmp280_get_measure_time_us(handle_, &measure_us_);
+    if (res != 0)
+        return res;
+    uint32_t standby_us;
+    res = bmp280_get_standby_time_us(handle_, &standby_us);
+    if (res != 0)
+        return res;
+
+    // The update is bracketed by a read while its conversion still runs and
+    // one in the standby after it, so the guard has to fit inside both
+    uint32_t conversion_us = period_us_ > standby_us ? period_us_ - standby_us : measure_us_;
+    guard_ = microseconds(std::clamp<uint32_t>(std::min({period_us_ / 16, conversion_us / 4, standby_us / 2}), 50, 5000));
+    lead_ = std::max(guard_, microseconds(conversion_us / 2));
+    period_ = microseconds(period_us_);
+    unmeasured_ = 0;
+    retries_ = 0;
+    missed_ = 0;
+    probes_ = 0;
+    failures_ = 0;
+    tick_ = SchedulerTick();
+
+    bmp280_sample_t sample;
+    return sync(sample);
+}
+
+uint8_t BMP280StreamReader::sync(bmp280_sample_t &sample)
+{
+    // Poll the status finely for up to two cycles to find the end of a
+    // conversion: a probe that finds it running followed by one that does
+    // not. Only then is the data read.
+    microseconds step = std::max(guard_ / 2, microseconds(25));
+    steady_clock::time_point limit = clock_.now() + 2 * period_ + microseconds(measure_us_);
+    steady_clock::time_point busy;
+    bool seen_busy = false;
+    probe_interval_ = 1;
+    unprobed_ = 0;
+    for (;;)
+    {
+        bool running;
+        uint8_t res = measuring(running);
+        if (res != 0)
+            return res;
+        steady_clock::time_point now = clock_.now();
+        if (running)
+        {
+            busy = now;
+            seen_busy = true;
+        }
+        else if (seen_busy)
+        {
+            anchor_ = busy + (now - busy) / 2;
+            tick_.woke = now;
+            return read(sample);
+        }
+        if (now >= limit)
+            return 5;
+        clock_.sleepFor(step);
+    }
+}
+
+uint8_t BMP280StreamReader::deliver(const bmp280_sample_t &sample, BMP280Reading &reading)
+{
+    reading.triggered = anchor_ - microseconds(measure_us_);
+    reading.completed = clock_.now();
+    tick_.index++;
+    tick_.skipped = missed_ - tick_missed_;
+    return compensateReading(handle_, sample, reading);
+}
+
+void BMP280StreamReader::track(steady_clock::time_point expected, int damping)
+{
+    // Whole cycles that passed unread; what is left is the phase error
+    // built up since the phase was last measured, spread over those cycles
+    nanoseconds error = anchor_ - expected;
+    int64_t cycles = (error + period_ / 2) / period_;
+    nanoseconds residual = error - cycles * period_;
+    missed_ += uint64_t(cycles);
+
+    nanoseconds nominal = microseconds(period_us_);
+    period_ = std::clamp(period_ + residual / (damping * (unmeasured_ + cycles + 1)), nominal * 7 / 8, nominal * 9 / 8);
+    unmeasured_ = 0;
+}
+
+uint8_t BMP280StreamReader::next(BMP280Reading &reading)
+{
+    uint8_t res = acquire(reading);
+    if (res == 0)
+    {
+        failures_ = 0;
+        return 0;
+    }
+
+    // A bus that stays failed must not turn the caller's loop into a spin;
+    // back off by whole periods, doubling up to kMaxBackoff, before the
+    // next attempt, which then resynchronizes
+    failures_++;
+    clock_.sleepFor(period_ * std::min(1 << std::min(failures_ - 1, 30), kMaxBackoff));
+    return res;
+}
+
+uint8_t BMP280StreamReader::acquire(BMP280Reading &reading)
+{
+    bmp280_sample_t sample;
+    uint8_t res;
+
+    tick_.deadline = anchor_ + period_ + guard_;
+    tick_missed_ = missed_;
+
+    // If the caller fell behind, the extrapolated phase cannot be trusted
+    // any more; lock onto the next update afresh
+    steady_clock::time_point now = clock_.now();
+    if (now > anchor_ + 2 * period_ - guard_)
+    {
+        // Counted once: the anchor moves past the cycles counted, so a
+        // failed sync does not count them again on the next call
+        int64_t cycles = (now - anchor_) / period_;
+        missed_ += uint64_t(cycles);
+        anchor_ += cycles * period_;
+        unmeasured_ = 0;
+        res = sync(sample);
+        if (res != 0)
+            return res;
+        return deliver(sample, reading);
+    }
+
+    // Every few cycles, and every cycle after a miss: halfway through the
+    // conversion that produces the predicted update the chip must be busy.
+    // Idle means the update either already happened or its conversion has
+    // not started, and only an observed end of conversion tells the two
+    // apart.
+    steady_clock::time_point expected = anchor_ + period_;
+    steady_clock::time_point busy;
+    bool probed = ++unprobed_ >= probe_interval_;
+    if (probed)
+    {
+        bool running;
+        unprobed_ = 0;
+        probes_++;
+        clock_.sleepUntil(expected - lead_);
+        res = measuring(running);
+        if (res != 0)
+            return res;
+        if (!running)
+        {
+            res = sync(sample);
+            if (res != 0)
+                return res;
+            track(expected, 1);
+            return deliver(sample, reading);
+        }
+    }
+
+    // A guard after the update an idle chip holds the new data, and this
+    // read is all a locked sample costs. Still busy means the conversion ran
+    // long or the phase slipped late, and the update lies between the last
+    // busy probe and the first idle one.
+    clock_.sleepUntil(expected + guard_);
+    tick_.woke = clock_.now();
+    res = read(sample);
+    if (res != 0)
+        return res;
+    if (!sample.measuring)
+    {
+        // Idle at the first try says no more than that the update fell
+        // before the read, so the phase stays on the prediction
+        anchor_ = expected;
+        unmeasured_++;
+        if (probed)
+            probe_interval_ = std::min(probe_interval_ * 2, kMaxProbeInterval);
+        return deliver(sample, reading);
+    }
+
+    steady_clock::time_point limit = expected + period_ + guard_;
+    now = clock_.now();
+    for (;;)
+    {
+        bool running;
+        busy = now;
+        if (now >= limit)
+        {
+            // Never idle for a whole cycle; stay on the nominal timeline
+            anchor_ += period_;
+            return 5;
+        }
+        retries_++;
+        clock_.sleepFor(guard_);
+        res = measuring(running);
+        if (res != 0)
+            return res;
+        now = clock_.now();
+        if (!running)
+            break;
+    }
+    res = read(sample);
+    if (res != 0)
+        return res;
+
+    // A retry bracket is only as fine as the guard, so it moves the period
+    // by half as much as the finer search does
+    anchor_ = busy + (now - busy) / 2;
+    track(expected, 2);
+    probe_interval_ = 1;
+    unprobed_ = 0;
+    return deliver(sample, reading);
+}
+
+uint8_t BMP280StreamReader::stop()
+{
+    return bmp280_set_mode(handle_, BMP280_MODE_SLEEP);
+}
@@ -0,0 +1,92 @@
+#ifndef STREAM_READER_H
+#define STREAM_READER_H
+
+    #include <chrono>
+    #include <cstdint>
+    #include "driver_bmp280.h"
+    #include "Clock.h"
+    #include "PeriodicScheduler.h"
+    #include "Reading.h"
+
+    // Normal-mode streaming reader.
+    //
+    // The sensor free-runs in BMP280_MODE_NORMAL and produces a new result
+    // every t_measure + t_standby. start() locks onto the sensor's cycle by
+    // watching the status register for the end of a conversion; next() then
+    // reads the data once, a guard after the predicted update. No trigger
+    // writes are issued while streaming.
+    //
+    // Freshness comes from the measuring bit, never from the data, since two
+    // identical results in a row are perfectly valid at low oversampling.
+    // Once the phase is locked, an idle chip a guard after the update is
+    // taken as the update, and steady-state traffic is one burst read per
+    // sample. A busy one means the conversion ran long or the phase slipped
+    // late; the status register is polled until it ends and the bracket
+    // gives the phase. Slipping early is invisible to that read, so every
+    // few cycles a 1-byte status probe halfway through the conversion checks
+    // that the chip is busy there: idle means the phase is off and the next
+    // end of conversion is searched for. The probe runs every cycle after a
+    // miss and backs off while the prediction holds. The phase errors found
+    // either way steer a running estimate of the sensor's actual period, so
+    // its oscillator tolerance does not accumulate.
+    class BMP280StreamReader {
+    public:
+        explicit BMP280StreamReader(bmp280_handle_t *handle, Clock &clock = Clock::system());
+
+        // Switch to normal mode with the given standby time and lock onto the
+        // sensor's cycle. Returns a driver status code.
+        uint8_t start(bmp280_standby_time_t standby);
+
+        // Wait for the next fresh sample. Returns a driver status code; a
+        // failure waits one period, doubling with every failure in a row up
+        // to kMaxBackoff periods, before it returns.
+        uint8_t next(BMP280Reading &reading);
+
+        // Wake-up of the last successful next(): the deadline is the
+        // predicted update plus the guard, woke is when the data read was
+        // issued and skipped the cycles that passed unread before it.
+        const SchedulerTick &tick() const { return tick_; }
+
+        // Put the sensor back to sleep.
+        uint8_t stop();
+
+        uint32_t periodUs() const { return period_us_; }
+        uint64_t retries() const { return retries_; }   // reads that found the conversion still running
+        uint64_t missed() const { return missed_; }     // cycles that passed unread
+        uint64_t probes() const { return probes_; }     // status probes that checked the phase
+        int failures() const { return failures_; }      // next() calls failed in a row
+
+        // Cycles between phase probes once the prediction holds.
+        static constexpr int kMaxProbeInterval = 16;
+
+        // Most periods waited after a failed next().
+        static constexpr int kMaxBackoff = 8;
+
+    private:
+        uint8_t acquire(BMP280Reading &reading);
+        uint8_t sync(bmp280_sample_t &sample);
+        uint8_t read(bmp280_sample_t &sample);
+        uint8_t measuring(bool &busy);
+        uint8_t deliver(const bmp280_sample_t &sample, BMP280Reading &reading);
+        void track(std::chrono::steady_clock::time_point expected, int damping);
+
+        bmp280_handle_t *handle_;
+        Clock &clock_;
+        uint32_t period_us_;
+        uint32_t measure_us_;
+        std::chrono::microseconds guard_;                // wake-up margin after the update
+        std::chrono::microseconds lead_;                 // wake-up margin before it, inside the conversion
+        std::chrono::nanoseconds period_;                // tracked cycle length, nominal at start
+        int64_t unmeasured_;                             // cycles since the phase was last measured
+        int probe_interval_;                             // cycles between phase probes, 1 after a miss
+        int unprobed_;                                   // cycles since the last phase probe
+        int failures_;                                   // next() calls failed in a row
+        std::chrono::steady_clock::time_point anchor_;   // predicted data update time
+        uint64_t retries_;
+        uint64_t missed_;
+        uint64_t probes_;
+        SchedulerTick tick_;
+        uint64_t tick_missed_;                           // missed_ when the current next() began
+    };
+
+#endif
@@ -0,0 +1,245 @@
+#include "TimerWheel.h"
+
+#include <algorithm>
+
+using std::chrono::nanoseconds;
+
+ThreadPool::ThreadPool(size_t threads) : stop_(false) {
+    for (size_t i = 0; i < (threads ? threads : 1); i++)
+        workers_.emplace_back(&ThreadPool::run, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    ready_.notify_all();
+    for (std::thread &worker : workers_)
+        worker.join();
+}
+
+void ThreadPool::post(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    ready_.notify_one();
+}
+
+void ThreadPool::run() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+            // Queued jobs still run on shutdown
+            if (jobs_.empty())
+                return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+
+TimerWheel::TimerWheel(std::chrono::microseconds tick, size_t threads, Clock &clock)
+    : tick_(tick.count() > 0 ? tick : std::chrono::microseconds(1)), clock_(clock), start_(clock.now()), now_(0),
+      next_id_(1), stop_(false), pool_(threads != 0 ? new ThreadPool(threads) : nullptr) {
+    if (pool_)
+        thread_ = std::thread(&TimerWheel::run, this);
+}
+
+TimerWheel::~TimerWheel() {
+    stop();
+}
+
+uint64_t TimerWheel::toTicks(nanoseconds d) const {
+    // Round up, so a task never runs early
+    int64_t tick_ns = nanoseconds(tick_).count();
+    int64_t ticks = (d.count() + tick_ns - 1) / tick_ns;
+    return ticks > 0 ? uint64_t(ticks) : 1;
+}
+
+TimerWheel::TaskId TimerWheel::schedule(nanoseconds period, std::function<void()> fn, nanoseconds delay) {
+    return add(period.count() > 0 ? period : nanoseconds(1), delay.count() > 0 ? delay : period, std::move(fn));
+}
+
+TimerWheel::TaskId TimerWheel::scheduleOnce(nanoseconds delay, std::function<void()> fn) {
+    return add(nanoseconds(0), delay, std::move(fn));
+}
+
+TimerWheel::TaskId TimerWheel::add(nanoseconds period, nanoseconds delay, std::function<void()> fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_)
+        return 0;
+
+    // The first release is counted from the clock, not from the last tick
+    // processed, which lags behind while the wheel catches up
+    std::shared_ptr<Task> task = std::make_shared<Task>();
+    task->id = next_id_++;
+    task->due = clock_.now() - start_ + delay;
+    task->expires = std::max(toTicks(task->due), now_ + 1);
+    task->period = period;
+    task->fn = std::move(fn);
+    link(task.get());
+    tasks_.emplace(task->id, task);
+    return task->id;
+}
+
+bool TimerWheel::cancel(TaskId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end())
+        return false;
+    unlink(it->second.get());
+    tasks_.erase(it);
+    return true;
+}
+
+void TimerWheel::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_)
+            return;
+        stop_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+size_t TimerWheel::poll() {
+    std::vector<std::function<void()>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pool_)
+            return 0;
+        Clock::time_point now = clock_.now();
+        while (!stop_ && start_ + tick_ * (now_ + 1) <= now)
+            advance();
+        jobs.swap(ready_);
+    }
+
+    // Outside the lock, so a task may schedule or cancel
+    for (std::function<void()> &job : jobs)
+        job();
+    return jobs.size();
+}
+
+size_t TimerWheel::tasks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+void TimerWheel::link(Task *task) {
+    if (task->expires < now_)
+        task->expires = now_;
+
+    // Coarsest level that still tells the expiry apart from now; past the
+    // top level the task waits in the slot furthest out
+    uint64_t delta = task->expires - now_;
+    uint64_t expires = task->expires;
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (kSlots << (kSlotBits * level)))
+        level++;
+    if (delta >= (kSlots << (kSlotBits * level)))
+        expires = now_ + (kSlots << (kSlotBits * level)) - 1;
+
+    Task *head = &wheel_[level][(expires >> (kSlotBits * level)) & kSlotMask].head;
+    task->prev = head->prev;
+    task->next = head;
+    head->prev->next = task;
+    head->prev = task;
+}
+
+void TimerWheel::unlink(Task *task) {
+    if (task->prev == nullptr)
+        return;
+    task->prev->next = task->next;
+    task->next->prev = task->prev;
+    task->prev = task->next = nullptr;
+}
+
+void TimerWheel::cascade(int level) {
+    Task *head = &wheel_[level][(now_ >> (kSlotBits * level)) & kSlotMask].head;
+    while (head->next != head) {
+        Task *task = head->next;
+        unlink(task);
+        link(task);
+    }
+}
+
+void TimerWheel::advance() {
+    now_++;
+
+    // Whenever a level wraps, the next slot of the level above moves down
+    for (int level = 1; level < kLevels && (now_ & ((uint64_t(1) << (kSlotBits * level)) - 1)) == 0; level++)
+        cascade(level);
+
+    // Detach the due slot before releasing, so re-arming never walks the
+    // list that is being drained
+    Slot due;
+    Task *head = &wheel_[0][now_ & kSlotMask].head;
+    if (head->next == head)
+        return;
+    due.head.next = head->next;
+    due.head.prev = head->prev;
+    due.head.next->prev = &due.head;
+    due.head.prev->next = &due.head;
+    head->next = head->prev = head;
+
+    while (due.head.next != &due.head) {
+        Task *task = due.head.next;
+        unlink(task);
+        if (task->expires > now_)
+            link(task);
+        else
+            release(task);
+    }
+}
+
+void TimerWheel::release(Task *task) {
+    std::shared_ptr<Task> owner = tasks_[task->id];
+
+    fired_.fetch_add(1, std::memory_order_relaxed);
+    if (task->running.exchange(true)) {
+        skipped_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        std::function<void()> job = [owner] {
+            owner->fn();
+            owner->running.store(false);
+        };
+        if (pool_)
+            pool_->post(std::move(job));
+        else
+            ready_.push_back(std::move(job));
+    }
+
+    // Re-arm from the exact deadline, not from now or from the rounded tick,
+    // so the period never drifts
+    if (task->period.count() != 0) {
+        task->due += task->period;
+        task->expires = std::max(toTicks(task->due), now_ + 1);
+        link(task);
+    } else {
+        tasks_.erase(task->id);
+    }
+}
+
+void TimerWheel::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        Clock::time_point deadline = start_ + tick_ * (now_ + 1);
+        Clock::time_point now = clock_.now();
+        if (now < deadline) {
+            wake_.wait_until(lock, deadline);
+            continue;
+        }
+
+        // Woken late: catch up one tick at a time so no slot is passed over
+        if (now >= deadline + tick_)
+            late_ticks_.fetch_add(1, std::memory_order_relaxed);
+        advance();
+    }
+}
@@ -0,0 +1,154 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+    #include <atomic>
+    #include <chrono>
+    #include <condition_variable>
+    #include <cstdint>
+    #include <deque>
+    #include <functional>
+    #include <memory>
+    #include <mutex>
+    #include <thread>
+    #include <unordered_map>
+    #include <vector>
+    #include "Clock.h"
+
+    // Fixed set of worker threads draining one FIFO of jobs.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(size_t threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        void post(std::function<void()> job);
+        size_t size() const { return workers_.size(); }
+
+    private:
+        void run();
+
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::deque<std::function<void()>> jobs_;
+        bool stop_;
+        std::vector<std::thread> workers_;
+    };
+
+    // Hierarchical timer wheel for many periodic tasks at different rates.
+    //
+    // Four levels of 64 slots each cover 64, 4096, 262144 and 16777216
+    // ticks; a timer goes into the coarsest level that still separates it
+    // from now and moves one level down each time the level below wraps.
+    // Insert and cancel are O(1) list operations, and each tick touches a
+    // single level-0 slot plus, once every 64 ticks, one cascading slot, so
+    // the cost does not grow with the number of tasks. Timers further out
+    // than the top level are parked in its last slot and re-filed when it
+    // cascades.
+    //
+    // One driver thread advances the wheel on absolute tick deadlines of the
+    // system clock and hands expired tasks to the thread pool, so a slow
+    // task never delays another one's release. Periodic tasks are re-armed
+    // from their previous deadline rather than from when they ran, and a
+    // task that is still running when it falls due again skips that release
+    // instead of running twice at once.
+    //
+    // With no threads there is neither a driver nor a pool: poll() advances
+    // the wheel to the clock and runs what was released on the caller's
+    // thread, so on a VirtualClock a schedule is a pure function of the
+    // clock steps. A task released again before poll() has run it skips
+    // the release, as it would if it were still running.
+    class TimerWheel {
+    public:
+        using TaskId = uint64_t;
+
+        explicit TimerWheel(std::chrono::microseconds tick = std::chrono::milliseconds(1), size_t threads = 2,
+                            Clock &clock = Clock::system());
+        ~TimerWheel();
+
+        TimerWheel(const TimerWheel &) = delete;
+        TimerWheel &operator=(const TimerWheel &) = delete;
+
+        // Run fn every period, the first time after delay (one period if
+        // zero). Spreading tasks of the same rate over different delays
+        // keeps them from all landing on the same tick. Returns 0 if the
+        // wheel has been stopped.
+        TaskId schedule(std::chrono::nanoseconds period, std::function<void()> fn,
+                        std::chrono::nanoseconds delay = std::chrono::nanoseconds(0));
+
+        // Run fn once after delay.
+        TaskId scheduleOnce(std::chrono::nanoseconds delay, std::function<void()> fn);
+
+        // Remove a task. A run already handed to the pool still completes.
+        bool cancel(TaskId id);
+
+        // Stop releasing tasks. Runs already handed to the pool finish
+        // before the wheel is destroyed.
+        void stop();
+
+        // Without threads: process every tick that is due on the clock,
+        // then run the released tasks here. Returns the number of runs; 0
+        // on a wheel with a driver thread.
+        size_t poll();
+
+        std::chrono::microseconds tick() const { return tick_; }
+        size_t tasks() const;
+        uint64_t fired() const { return fired_.load(std::memory_order_relaxed); }
+        uint64_t skipped() const { return skipped_.load(std::memory_order_relaxed); }   // releases that found the task still running
+        uint64_t lateTicks() const { return late_ticks_.load(std::memory_order_relaxed); }  // ticks processed after their deadline had passed
+
+    private:
+        static const int kLevels = 4;
+        static const int kSlotBits = 6;
+        static const uint64_t kSlots = 1 << kSlotBits;
+        static const uint64_t kSlotMask = kSlots - 1;
+
+        struct Task {
+            TaskId id;
+            uint64_t expires;                  // tick of the next release, due rounded up
+            std::chrono::nanoseconds due;      // exact next release, since start_
+            std::chrono::nanoseconds period;   // 0 for one-shot
+            std::function<void()> fn;
+            std::atomic<bool> running{false};
+            Task *prev = nullptr;              // slot list links, owned by the wheel
+            Task *next = nullptr;
+        };
+
+        // Intrusive circular list head
+        struct Slot {
+            Task head;
+            Slot() { head.prev = head.next = &head; }
+        };
+
+        TaskId add(std::chrono::nanoseconds period, std::chrono::nanoseconds delay, std::function<void()> fn);
+        uint64_t toTicks(std::chrono::nanoseconds d) const;
+        void link(Task *task);
+        static void unlink(Task *task);
+        void cascade(int level);
+        void advance();
+        void release(Task *task);
+        void run();
+
+        const std::chrono::microseconds tick_;
+        Clock &clock_;
+        Clock::time_point start_;
+        uint64_t now_;                         // ticks processed since start_
+        TaskId next_id_;
+        Slot wheel_[kLevels][kSlots];
+        std::unordered_map<TaskId, std::shared_ptr<Task>> tasks_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable wake_;
+        bool stop_;
+
+        std::atomic<uint64_t> fired_{0};
+        std::atomic<uint64_t> skipped_{0};
+        std::atomic<uint64_t> late_ticks_{0};
+
+        std::unique_ptr<ThreadPool> pool_;     // null without threads
+        std::vector<std::function<void()>> ready_;  // released runs waiting for poll()
+        std::thread thread_;
+    };
+
+#endif
@@ -0,0 +1,128 @@
+#include "WarmCache.h"
+#include <cstdio>
+#include <cstring>
+
+// Layout, all multi-byte values little-endian:
+//   0  magic "BMPW"
+//   4  version
+//   5  address
+//   6  chip id
+//   7  ctrl meas
+//   8  config
+//   9  bus path, zero padded
+//  41  calibration t1..p9 as 12 x 16 bit, NVM order
+//  65  FNV-1a 32 over bytes 0..64
+static const size_t kPathLen = 32;
+static const size_t kBodyLen = 9 + kPathLen + 24;
+static const size_t kFileLen = kBodyLen + 4;
+static const uint8_t kVersion = 1;
+
+static uint32_t checksum(const uint8_t *buf, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+        h ^= buf[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = uint8_t(v);
+    p[1] = uint8_t(v >> 8);
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+    return uint16_t(p[0] | (p[1] << 8));
+}
+
+bool loadWarmCache(const std::string &path, std::string &bus, uint8_t &addr, bmp280_warm_state_t &state)
+{
+    uint8_t buf[kFileLen + 1];
+    FILE *f = std::fopen(path.c_str(), "rb");
+    if (f == nullptr)
+        return false;
+    size_t n = std::fread(buf, 1, sizeof(buf), f);
+    std::fclose(f);
+
+    if (n != kFileLen || std::memcmp(buf, "BMPW", 4) != 0 || buf[4] != kVersion)
+        return false;
+    uint32_t stored = uint32_t(buf[kBodyLen]) | uint32_t(buf[kBodyLen + 1]) << 8 |
+                      uint32_t(buf[kBodyLen + 2]) << 16 | uint32_t(buf[kBodyLen + 3]) << 24;
+    if (stored != checksum(buf, kBodyLen))
+        return false;
+
+    char key[kPathLen + 1] = {};
+    std::memcpy(key, buf + 9, kPathLen);
+    if (key[0] == '\0')
+        return false;
+
+    const uint8_t *c = buf + 9 + kPathLen;
+    bus = key;
+    addr = buf[5];
+    state.chip_id = buf[6];
+    state.ctrl_meas = buf[7];
+    state.config = buf[8];
+    state.calibration.t1 = get16(c + 0);
+    state.calibration.t2 = int16_t(get16(c + 2));
+    state.calibration.t3 = int16_t(get16(c + 4));
+    state.calibration.p1 = get16(c + 6);
+    state.calibration.p2 = int16_t(get16(c + 8));
+    state.calibration.p3 = int16_t(get16(c + 10));
+    state.calibration.p4 = int16_t(get16(c + 12));
+    state.calibration.p5 = int16_t(get16(c + 14));
+    state.calibration.p6 = int16_t(get16(c + 16));
+    state.calibration.p7 = int16_t(get16(c + 18));
+    state.calibration.p8 = int16_t(get16(c + 20));
+    state.calibration.p9 = int16_t(get16(c + 22));
+    return true;
+}
+
+bool saveWarmCache(const std::string &path, const char *bus, uint8_t addr, const bmp280_warm_state_t &state)
+{
+    uint8_t buf[kFileLen] = {};
+    std::memcpy(buf, "BMPW", 4);
+    buf[4] = kVersion;
+    buf[5] = addr;
+    buf[6] = state.chip_id;
+    buf[7] = state.ctrl_meas;
+    buf[8] = state.config;
+    std::strncpy(reinterpret_cast<char *>(buf + 9), bus, kPathLen);
+
+    uint8_t *c = buf + 9 + kPathLen;
+    put16(c + 0, state.calibration.t1);
+    put16(c + 2, uint16_t(state.calibration.t2));
+    put16(c + 4, uint16_t(state.calibration.t3));
+    put16(c + 6, state.calibration.p1);
+    put16(c + 8, uint16_t(state.calibration.p2));
+    put16(c + 10, uint16_t(state.calibration.p3));
+    put16(c + 12, uint16_t(state.calibration.p4));
+    put16(c + 14, uint16_t(state.calibration.p5));
+    put16(c + 16, uint16_t(state.calibration.p6));
+    put16(c + 18, uint16_t(state.calibration.p7));
+    put16(c + 20, uint16_t(state.calibration.p8));
+    put16(c + 22, uint16_t(state.calibration.p9));
+
+    uint32_t sum = checksum(buf, kBodyLen);
+    buf[kBodyLen] = uint8_t(sum);
+    buf[kBodyLen + 1] = uint8_t(sum >> 8);
+    buf[kBodyLen + 2] = uint8_t(sum >> 16);
+    buf[kBodyLen + 3] = uint8_t(sum >> 24);
+
+    // A restart racing the write sees either the old file or the new one
+    std::string tmp = path + ".tmp";
+    FILE *f = std::fopen(tmp.c_str(), "wb");
+    if (f == nullptr)
+        return false;
+    bool ok = std::fwrite(buf, 1, sizeof(buf), f) == sizeof(buf);
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
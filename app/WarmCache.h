@@ -0,0 +1,24 @@
+#ifndef WARM_CACHE_H
+#define WARM_CACHE_H
+
+    #include <cstdint>
+    #include <string>
+    #include "driver_bmp280.h"
+
+    // Warm-start cache file.
+    //
+    // Holds one bmp280_warm_state_t keyed by the bus device path and I2C
+    // address, so a warm start needs no discovery. The chip ID and the NVM
+    // calibration are part of the state and are checked against the chip by
+    // bmp280_init_warm(), which also rejects the cache if the chip was reset
+    // or reconfigured since it was written. The file is small, fixed-size
+    // and checksummed; anything unexpected is treated as a miss.
+
+    // Load the cache. On success bus and addr receive the adapter path and
+    // sensor address the cache was written for.
+    bool loadWarmCache(const std::string &path, std::string &bus, uint8_t &addr, bmp280_warm_state_t &state);
+
+    // Write the cache atomically (temporary file plus rename).
+    bool saveWarmCache(const std::string &path, const char *bus, uint8_t addr, const bmp280_warm_state_t &state);
+
+#endif
@@ -0,0 +1,309 @@
+// Compensation benchmark: driver float path on the coefficients folded at
+// init, batched float kernel, the header-only C++ driver, driver
+// fixed-point path and the double formula in App.h, both term by term and
+// folded, timed over the same synthetic raw samples. The term-by-term
+// double result is the reference for the deviation columns. The header-only
+// driver is also run on the simulator through the C callback policies.
+// Exits non-zero when a path that must be bit-identical to the scalar float
+// compensation is not.
+//
+//   make bench && ./bench_compensation [samples]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "driver_bmp280.h"
+#include "driver_bmp280.hpp"
+#include "driver_bmp280_interface.h"
+#include "driver_bmp280_interface_sim.h"
+#include "App.h"
+
+using std::chrono::steady_clock;
+
+// Calibration example from the BMP280 datasheet, section 3.12
+static const Registers gs_calib = {27504, 26435, -1000,
+                                   36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000};
+
+static bmp280_calibration_t load_calibration()
+{
+    bmp280_calibration_t calib;
+    calib.t1 = gs_calib.dig_T1;
+    calib.t2 = gs_calib.dig_T2;
+    calib.t3 = gs_calib.dig_T3;
+    calib.p1 = gs_calib.dig_P1;
+    calib.p2 = gs_calib.dig_P2;
+    calib.p3 = gs_calib.dig_P3;
+    calib.p4 = gs_calib.dig_P4;
+    calib.p5 = gs_calib.dig_P5;
+    calib.p6 = gs_calib.dig_P6;
+    calib.p7 = gs_calib.dig_P7;
+    calib.p8 = gs_calib.dig_P8;
+    calib.p9 = gs_calib.dig_P9;
+    return calib;
+}
+
+// Bus policy for the header-only driver: serves the chip ID and the
+// calibration for init() and answers every data burst with the next
+// sample, so a read goes through transfer, decode and compensation with
+// no I/O cost
+class SampleBus
+{
+public:
+    SampleBus(const bmp280_calibration_t &calib, const std::vector<bmp280_sample_t> &samples)
+        : samples_(samples), next_(0)
+    {
+        const uint16_t words[12] = {calib.t1, (uint16_t)calib.t2, (uint16_t)calib.t3, calib.p1,
+                                    (uint16_t)calib.p2, (uint16_t)calib.p3, (uint16_t)calib.p4, (uint16_t)calib.p5,
+                                    (uint16_t)calib.p6, (uint16_t)calib.p7, (uint16_t)calib.p8, (uint16_t)calib.p9};
+        for (int i = 0; i < 12; i++)
+        {
+            nvm_[2 * i] = (uint8_t)words[i];
+            nvm_[2 * i + 1] = (uint8_t)(words[i] >> 8);
+        }
+    }
+
+    uint8_t read(uint8_t reg, uint8_t *buf, uint16_t len)
+    {
+        if (reg == bmp280::RegId::address && len == 1)
+        {
+            buf[0] = bmp280::RegId::chip_id;
+            return 0;
+        }
+        if (reg == bmp280::RegCalibration::address && len == sizeof(nvm_))
+        {
+            std::memcpy(buf, nvm_, sizeof(nvm_));
+            return 0;
+        }
+        if (reg != bmp280::RegData::address || len != bmp280::RegData::length)
+            return 1;
+        const bmp280_sample_t &s = samples_[next_++ % samples_.size()];
+        buf[0] = (uint8_t)(s.pressure_raw >> 12);
+        buf[1] = (uint8_t)(s.pressure_raw >> 4);
+        buf[2] = (uint8_t)(s.pressure_raw << 4);
+        buf[3] = (uint8_t)(s.temperature_raw >> 12);
+        buf[4] = (uint8_t)(s.temperature_raw >> 4);
+        buf[5] = (uint8_t)(s.temperature_raw << 4);
+        return 0;
+    }
+
+    uint8_t write(uint8_t, const uint8_t *, uint16_t) { return 0; }
+    void delay_us(uint32_t) {}
+
+private:
+    uint8_t nvm_[24];
+    const std::vector<bmp280_sample_t> &samples_;
+    size_t next_;
+};
+
+// Virtual time for the simulator: the driver delays advance it, so forced
+// conversions complete without sleeping
+static uint64_t gs_sim_now_us;
+
+static uint64_t sim_now_us(void *) { return gs_sim_now_us; }
+static void sim_sleep_us(void *, uint64_t us) { gs_sim_now_us += us; }
+static void sim_delay_us(uint32_t us) { gs_sim_now_us += us; }
+
+// Forced conversions through the header-only driver on a bus policy over
+// the C callbacks; each result must match the C float compensation of the
+// raw values left in the simulator's data registers
+template <class Bus>
+static size_t check_sim_driver(Bus &bus, bmp280_interface_sim_t &sim, uint32_t conversions)
+{
+    using Forced = bmp280::Preset<BMP280_OVERSAMPLING_x2, BMP280_OVERSAMPLING_x16, BMP280_MODE_FORCED>;
+    bmp280::Driver<Bus> driver(bus);
+    if (driver.init() != 0 || driver.template configure<Forced>() != 0)
+        return conversions;
+    const bmp280_coefficients_t coeff = bmp280_compile_calibration(&sim.calibration);
+    size_t mismatch = 0;
+    for (uint32_t i = 0; i < conversions; i++)
+    {
+        (void)bmp280_interface_sim_set_environment(&sim, -20.0f + 80.0f * i / conversions,
+                                                   30000.0f + 80000.0f * i / conversions);
+        bmp280_compensation_t got;
+        uint8_t buf[6];
+        if (driver.measure(got) != 0 || bmp280_interface_sim_iic_read(&sim, sim.addr, 0xF7, buf, sizeof(buf)) != 0)
+        {
+            mismatch++;
+            continue;
+        }
+        uint32_t pressure_raw = (uint32_t)buf[0] << 12 | (uint32_t)buf[1] << 4 | (uint32_t)buf[2] >> 4;
+        uint32_t temperature_raw = (uint32_t)buf[3] << 12 | (uint32_t)buf[4] << 4 | (uint32_t)buf[5] >> 4;
+        bmp280_compensation_t want = bmp280_compensate_compiled(&coeff, temperature_raw, pressure_raw);
+        if (std::memcmp(&got.temperature_c, &want.temperature_c, sizeof(float)) != 0 ||
+            std::memcmp(&got.pressure_pa, &want.pressure_pa, sizeof(float)) != 0)
+            mismatch++;
+    }
+    return mismatch;
+}
+
+template <typename F>
+static double time_ns(size_t n, F &&body)
+{
+    steady_clock::time_point start = steady_clock::now();
+    for (size_t i = 0; i < n; i++)
+        body(i);
+    return std::chrono::duration<double, std::nano>(steady_clock::now() - start).count() / n;
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 0) : 1000000;
+    const bmp280_calibration_t calib = load_calibration();
+    const bmp280_coefficients_t coeff = bmp280_compile_calibration(&calib);
+
+    // Raw values spanning roughly -20..60 degC and 300..1100 hPa, from a
+    // fixed-seed LCG so every run sees the same inputs
+    std::vector<bmp280_sample_t> samples(n);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < n; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        samples[i].temperature_raw = 430000 + (seed >> 8) % 170000;
+        seed = seed * 1664525u + 1013904223u;
+        samples[i].pressure_raw = 250000 + (seed >> 8) % 350000;
+    }
+
+    std::vector<double> ref_t(n), ref_p(n);
+    std::vector<float> flt_t(n), flt_p(n);
+    std::vector<int32_t> fix_t(n);
+    std::vector<uint32_t> fix_p(n);
+    size_t flt_fail = 0, fix_fail = 0;
+
+    double ns_double = time_ns(n, [&](size_t i) {
+        BMP280RawData raw;
+        raw.adc_T = (int32_t)samples[i].temperature_raw;
+        raw.adc_P = (int32_t)samples[i].pressure_raw;
+        raw.calib = gs_calib;
+        BMP280Compensated c = compensateBMP280(raw);
+        ref_t[i] = c.temperature;
+        ref_p[i] = c.pressure * 100.0;
+    });
+    const BMP280Folded folded = foldBMP280(gs_calib);
+    std::vector<double> fld_t(n), fld_p(n);
+    double ns_folded = time_ns(n, [&](size_t i) {
+        BMP280RawData raw;
+        raw.adc_T = (int32_t)samples[i].temperature_raw;
+        raw.adc_P = (int32_t)samples[i].pressure_raw;
+        BMP280Compensated c = compensateBMP280(raw, folded);
+        fld_t[i] = c.temperature;
+        fld_p[i] = c.pressure * 100.0;
+    });
+    double ns_float = time_ns(n, [&](size_t i) {
+        bmp280_compensation_t c = bmp280_compensate_compiled(&coeff, samples[i].temperature_raw, samples[i].pressure_raw);
+        flt_t[i] = c.temperature_c;
+        flt_p[i] = c.pressure_pa;
+        if (c.status != BMP280_COMPENSATE_OK)
+            flt_fail++;
+    });
+
+    // The batch kernel runs once over the whole arrays; it must match the
+    // scalar float path bit for bit
+    std::vector<uint32_t> raw_t(n), raw_p(n);
+    std::vector<float> bat_t(n), bat_p(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        raw_t[i] = samples[i].temperature_raw;
+        raw_p[i] = samples[i].pressure_raw;
+    }
+    steady_clock::time_point batch_start = steady_clock::now();
+    size_t bat_fail = bmp280_compensate_batch(&calib, raw_t.data(), raw_p.data(), bat_t.data(), bat_p.data(),
+                                              nullptr, (uint32_t)n);
+    double ns_batch = std::chrono::duration<double, std::nano>(steady_clock::now() - batch_start).count() / n;
+    size_t bat_mismatch = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (std::memcmp(&bat_t[i], &flt_t[i], sizeof(float)) != 0 || std::memcmp(&bat_p[i], &flt_p[i], sizeof(float)) != 0)
+            bat_mismatch++;
+    }
+
+    // Header-only driver: compensation alone, then the whole read path on a
+    // bus that hands out the same samples; both must match the C driver
+    std::vector<float> inl_t(n), inl_p(n), drv_t(n), drv_p(n);
+    double ns_inline = time_ns(n, [&](size_t i) {
+        bmp280_compensation_t c = bmp280::compensate(coeff, samples[i].temperature_raw, samples[i].pressure_raw);
+        inl_t[i] = c.temperature_c;
+        inl_p[i] = c.pressure_pa;
+    });
+    SampleBus sample_bus(calib, samples);
+    bmp280::Driver<SampleBus> driver(sample_bus);
+    driver.init();
+    double ns_driver = time_ns(n, [&](size_t i) {
+        bmp280_compensation_t c;
+        driver.read(c);
+        drv_t[i] = c.temperature_c;
+        drv_p[i] = c.pressure_pa;
+    });
+    size_t inl_mismatch = 0;
+    bmp280_coefficients_t hpp_coeff = bmp280::compile(calib);
+    if (std::memcmp(&hpp_coeff, &coeff, sizeof(coeff)) != 0)
+        inl_mismatch = n;
+    for (size_t i = 0; i < n && inl_mismatch != n; i++)
+    {
+        if (std::memcmp(&inl_t[i], &flt_t[i], sizeof(float)) != 0 || std::memcmp(&inl_p[i], &flt_p[i], sizeof(float)) != 0 ||
+            std::memcmp(&drv_t[i], &flt_t[i], sizeof(float)) != 0 || std::memcmp(&drv_p[i], &flt_p[i], sizeof(float)) != 0)
+            inl_mismatch++;
+    }
+
+    // The same driver on the simulator, over iic and over spi framing
+    bmp280_interface_sim_t iic_sim, spi_sim;
+    (void)bmp280_interface_sim_init(&iic_sim, 0x76);
+    (void)bmp280_interface_sim_init(&spi_sim, 0x76);
+    iic_sim.now_us = spi_sim.now_us = sim_now_us;
+    iic_sim.sleep_us = spi_sim.sleep_us = sim_sleep_us;
+    bmp280::IICCallbackBus iic_bus(&iic_sim, iic_sim.addr, bmp280_interface_sim_iic_read,
+                                   bmp280_interface_sim_iic_write, sim_delay_us);
+    bmp280_interface_spi_bus_t spi;
+    (void)bmp280_interface_spi_bus_init_path(&spi, "sim");
+    (void)bmp280_interface_spi_set_transfer(&spi, bmp280_interface_sim_spi_transfer, &spi_sim);
+    bmp280::SPICallbackBus spi_bus(&spi, bmp280_interface_spi_read, bmp280_interface_spi_write, sim_delay_us);
+    size_t sim_mismatch = 256;
+    if (bmp280_interface_sim_iic_init(&iic_sim) == 0 && bmp280_interface_sim_iic_init(&spi_sim) == 0 &&
+        bmp280_interface_spi_init(&spi) == 0)
+    {
+        sim_mismatch = check_sim_driver(iic_bus, iic_sim, 128) + check_sim_driver(spi_bus, spi_sim, 128);
+        (void)bmp280_interface_spi_deinit(&spi);
+    }
+
+    double ns_fixed = time_ns(n, [&](size_t i) {
+        bmp280_compensation_fixed_t c = bmp280_compensate_fixed(&calib, samples[i].temperature_raw, samples[i].pressure_raw);
+        fix_t[i] = c.temperature_centi_c;
+        fix_p[i] = c.pressure_q24_8;
+        if (c.status != BMP280_COMPENSATE_OK)
+            fix_fail++;
+    });
+
+    // Deviation against double, over the samples every path accepted
+    double fld_dt = 0, fld_dp = 0, flt_dt = 0, flt_dp = 0, bat_dt = 0, bat_dp = 0, fix_dt = 0, fix_dp = 0;
+    size_t compared = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (ref_t[i] < -40.0 || ref_t[i] > 85.0 || ref_p[i] < 30000.0 || ref_p[i] > 110000.0)
+            continue;
+        compared++;
+        fld_dt = std::fmax(fld_dt, std::fabs(fld_t[i] - ref_t[i]));
+        fld_dp = std::fmax(fld_dp, std::fabs(fld_p[i] - ref_p[i]));
+        flt_dt = std::fmax(flt_dt, std::fabs(flt_t[i] - ref_t[i]));
+        flt_dp = std::fmax(flt_dp, std::fabs(flt_p[i] - ref_p[i]));
+        bat_dt = std::fmax(bat_dt, std::fabs(bat_t[i] - ref_t[i]));
+        bat_dp = std::fmax(bat_dp, std::fabs(bat_p[i] - ref_p[i]));
+        fix_dt = std::fmax(fix_dt, std::fabs(fix_t[i] / 100.0 - ref_t[i]));
+        fix_dp = std::fmax(fix_dp, std::fabs(fix_p[i] / 256.0 - ref_p[i]));
+    }
+
+    std::printf("%zu samples, %zu inside the sensor range\n", n, compared);
+    std::printf("%-8s %10s %14s %14s %8s\n", "path", "ns/sample", "max |dT| degC", "max |dP| Pa", "clamped");
+    std::printf("%-8s %10.1f %14s %14s %8s\n", "double", ns_double, "-", "-", "-");
+    std::printf("%-8s %10.1f %14.2e %14.2e %8s\n", "folded", ns_folded, fld_dt, fld_dp, "-");
+    std::printf("%-8s %10.1f %14.5f %14.3f %8zu\n", "float", ns_float, flt_dt, flt_dp, flt_fail);
+    std::printf("%-8s %10.1f %14.5f %14.3f %8zu\n", "batch", ns_batch, bat_dt, bat_dp, bat_fail);
+    std::printf("%-8s %10.1f %14s %14s %8s\n", "inline", ns_inline, "-", "-", "-");
+    std::printf("%-8s %10.1f %14s %14s %8s\n", "hpp read", ns_driver, "-", "-", "-");
+    std::printf("%-8s %10.1f %14.5f %14.3f %8zu\n", "fixed", ns_fixed, fix_dt, fix_dp, fix_fail);
+    std::printf("batch vs float mismatches: %zu\n", bat_mismatch);
+    std::printf("hpp vs float mismatches: %zu\n", inl_mismatch);
+    std::printf("hpp on sim vs float mismatches: %zu\n", sim_mismatch);
+    return bat_mismatch == 0 && inl_mismatch == 0 && sim_mismatch == 0 ? 0 : 1;
+}
@@ -0,0 +1,269 @@
+// Bus checks on the simulator:
+//  - batched SPI reads over several chips must return the same bytes as one
+//    bmp280_interface_spi_read per register block, with one transfer hook
+//    call per chip instead of one per read
+//  - driver handles on several chips, each on its own thread, share one
+//    BusWorker; every read must land in the right buffer, and reads queued
+//    while the bus is busy must go out together as batches
+// Exits non-zero on any difference.
+//
+//   make check
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "driver_bmp280.h"
+#include "driver_bmp280_interface.h"
+#include "driver_bmp280_interface_sim.h"
+#include "BusWorker.h"
+
+static const uint32_t kChips = 4;
+
+// Virtual time shared by every simulated chip
+static uint64_t gs_now_us;
+
+static uint64_t sim_now_us(void *) { return gs_now_us; }
+static void sim_sleep_us(void *, uint64_t us) { gs_now_us += us; }
+
+// One chip on its own chip select, with the hook calls counted
+struct Chip
+{
+    bmp280_interface_sim_t sim;
+    bmp280_interface_spi_bus_t bus;
+    uint32_t messages;
+};
+
+static uint8_t count_transfer(void *ctx, const bmp280_interface_spi_xfer_t *xfers, uint32_t count)
+{
+    Chip *chip = (Chip *)ctx;
+    chip->messages++;
+    return bmp280_interface_sim_spi_transfer(&chip->sim, xfers, count);
+}
+
+static uint32_t total_messages(const Chip *chips)
+{
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < kChips; i++)
+        total += chips[i].messages;
+    return total;
+}
+
+static uint32_t check_spi_read_batch(Chip *chips)
+{
+    uint32_t failures = 0;
+
+    // A forced conversion on every chip, each in a different environment
+    for (uint32_t i = 0; i < kChips; i++)
+    {
+        uint8_t ctrl_meas = 0x25;                   /* x1 / x1, forced */
+        (void)bmp280_interface_sim_set_environment(&chips[i].sim, 10.0f * i, 90000.0f + 5000.0f * i);
+        if (bmp280_interface_spi_write(&chips[i].bus, 0x74, &ctrl_meas, 1) != 0)
+            failures++;
+    }
+    if (bmp280_interface_spi_write(&chips[0].bus, 0x74, nullptr, 0) == 0)
+        failures++;
+    gs_now_us += 10000;
+
+    // Calibration and status-to-data window of every chip, one at a time
+    uint8_t calib[kChips][24], window[kChips][10];
+    for (uint32_t i = 0; i < kChips; i++)
+        chips[i].messages = 0;
+    for (uint32_t i = 0; i < kChips; i++)
+    {
+        if (bmp280_interface_spi_read(&chips[i].bus, 0x88 | 0x80, calib[i], sizeof(calib[i])) != 0 ||
+            bmp280_interface_spi_read(&chips[i].bus, 0xF3 | 0x80, window[i], sizeof(window[i])) != 0)
+            failures++;
+    }
+    uint32_t single = total_messages(chips);
+
+    // The same reads batched, the two reads of a chip back to back
+    uint8_t batch_calib[kChips][24], batch_window[kChips][10];
+    bmp280_interface_spi_read_t reads[2 * kChips];
+    for (uint32_t i = 0; i < kChips; i++)
+    {
+        reads[2 * i] = {&chips[i].bus, 0x88, batch_calib[i], sizeof(batch_calib[i])};
+        reads[2 * i + 1] = {&chips[i].bus, 0xF3, batch_window[i], sizeof(batch_window[i])};
+        chips[i].messages = 0;
+    }
+    if (bmp280_interface_spi_read_batch(reads, 2 * kChips) != 0)
+        failures++;
+    uint32_t batched = total_messages(chips);
+
+    for (uint32_t i = 0; i < kChips; i++)
+    {
+        if (std::memcmp(calib[i], batch_calib[i], sizeof(calib[i])) != 0 ||
+            std::memcmp(window[i], batch_window[i], sizeof(window[i])) != 0)
+            failures++;
+    }
+    for (uint32_t i = 1; i < kChips; i++)
+    {
+        if (std::memcmp(&window[i][4], &window[0][4], 6) == 0)
+            failures++;                             /* chips must not alias */
+    }
+    if (batched != kChips)
+        failures++;
+
+    std::printf("spi read batch: %u chips, %u messages single, %u batched, %u failures\n", kChips, single,
+                batched, failures);
+    return failures;
+}
+
+// Several chips on one I2C adapter, told apart by address
+struct SimAdapter
+{
+    bmp280_interface_sim_t sims[kChips];
+    uint32_t batches;                               /* readBatch calls */
+    uint32_t batched_reads;                         /* reads that went out in them */
+};
+
+static bmp280_interface_sim_t *adapter_sim(void *bus, uint8_t addr)
+{
+    SimAdapter *adapter = (SimAdapter *)bus;
+    for (uint32_t i = 0; i < kChips; i++)
+    {
+        if (adapter->sims[i].addr == addr)
+            return &adapter->sims[i];
+    }
+    return nullptr;
+}
+
+static uint8_t adapter_init(void *bus)
+{
+    SimAdapter *adapter = (SimAdapter *)bus;
+    for (uint32_t i = 0; i < kChips; i++)
+        (void)bmp280_interface_sim_iic_init(&adapter->sims[i]);
+    return 0;
+}
+
+static uint8_t adapter_deinit(void *bus)
+{
+    SimAdapter *adapter = (SimAdapter *)bus;
+    for (uint32_t i = 0; i < kChips; i++)
+        (void)bmp280_interface_sim_iic_deinit(&adapter->sims[i]);
+    return 0;
+}
+
+static uint8_t adapter_read(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    return bmp280_interface_sim_iic_read(adapter_sim(bus, addr), addr, reg, buf, len);
+}
+
+static uint8_t adapter_write(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    return bmp280_interface_sim_iic_write(adapter_sim(bus, addr), addr, reg, buf, len);
+}
+
+static uint8_t adapter_read_batch(void *bus, bmp280_interface_iic_read_t *reads, uint32_t count)
+{
+    SimAdapter *adapter = (SimAdapter *)bus;
+    uint8_t res = 0;
+
+    adapter->batches++;
+    adapter->batched_reads += count;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        reads[i].result = adapter_read(bus, reads[i].addr, reads[i].reg, reads[i].buf, reads[i].len);
+        res |= reads[i].result;
+    }
+    return res;
+}
+
+static uint32_t check_bus_worker()
+{
+    static const uint32_t kReads = 200;
+    static SimAdapter adapter;
+    std::vector<uint32_t> failures(kChips, 0);
+
+    for (uint32_t i = 0; i < kChips; i++)
+    {
+        bmp280_calibration_t calibration;
+
+        (void)bmp280_interface_sim_init(&adapter.sims[i], (uint8_t)(0x70 + i));
+        calibration = adapter.sims[i].calibration;
+        calibration.t1 = (uint16_t)(calibration.t1 + i);
+        (void)bmp280_interface_sim_set_calibration(&adapter.sims[i], &calibration);
+        adapter.sims[i].latency_us = 50;            /* keep the bus busy while others queue */
+    }
+    BusWorker worker({&adapter, adapter_init, adapter_deinit, adapter_read, adapter_write, adapter_read_batch});
+
+    // One driver handle per chip, each polling its calibration from its own
+    // thread through the blocking worker callbacks
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < kChips; i++)
+    {
+        threads.emplace_back([&worker, &failures, i]() {
+            bmp280_handle_t handle;
+            DRIVER_BMP280_LINK_INIT(&handle, bmp280_handle_t);
+            DRIVER_BMP280_LINK_BUS(&handle, &worker);
+            DRIVER_BMP280_LINK_IIC_INIT(&handle, BusWorker::iicInit);
+            DRIVER_BMP280_LINK_IIC_DEINIT(&handle, BusWorker::iicDeinit);
+            DRIVER_BMP280_LINK_IIC_READ(&handle, BusWorker::iicRead);
+            DRIVER_BMP280_LINK_IIC_WRITE(&handle, BusWorker::iicWrite);
+            DRIVER_BMP280_LINK_SPI_INIT(&handle, bmp280_interface_spi_init);
+            DRIVER_BMP280_LINK_SPI_DEINIT(&handle, bmp280_interface_spi_deinit);
+            DRIVER_BMP280_LINK_SPI_READ(&handle, bmp280_interface_spi_read);
+            DRIVER_BMP280_LINK_SPI_WRITE(&handle, bmp280_interface_spi_write);
+            DRIVER_BMP280_LINK_DELAY_MS(&handle, bmp280_interface_delay_ms);
+            DRIVER_BMP280_LINK_DELAY_US(&handle, bmp280_interface_delay_us);
+            DRIVER_BMP280_LINK_DEBUG_PRINT(&handle, bmp280_interface_debug_print);
+            (void)bmp280_set_interface(&handle, BMP280_INTERFACE_IIC);
+            handle.iic_addr = (uint8_t)(0x70 + i);
+            if (bmp280_init(&handle) != 0)
+            {
+                failures[i]++;
+                return;
+            }
+            const uint8_t *expect = &adapter.sims[i].regs[0x88];
+            for (uint32_t n = 0; n < kReads; n++)
+            {
+                uint8_t calib[24];
+                if (BusWorker::iicRead(&worker, handle.iic_addr, 0x88, calib, sizeof(calib)) != 0 ||
+                    std::memcmp(calib, expect, sizeof(calib)) != 0)
+                    failures[i]++;
+            }
+            (void)bmp280_deinit(&handle);
+        });
+    }
+    for (std::thread &t : threads)
+        t.join();
+
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < kChips; i++)
+        total += failures[i];
+    if (adapter.batches == 0)
+        total++;                                    /* nothing was coalesced */
+
+    std::printf("bus worker: %u handles, %llu transfers in %llu wake-ups, %u reads in %u batches, %u failures\n",
+                kChips, (unsigned long long)worker.transfers(), (unsigned long long)worker.batches(),
+                adapter.batched_reads, adapter.batches, total);
+    return total;
+}
+
+int main()
+{
+    static Chip chips[kChips];
+
+    for (uint32_t i = 0; i < kChips; i++)
+    {
+        char path[32];
+        std::snprintf(path, sizeof(path), "sim%u", i);
+        if (bmp280_interface_sim_init(&chips[i].sim, 0x76) != 0 ||
+            bmp280_interface_spi_bus_init_path(&chips[i].bus, path) != 0 ||
+            bmp280_interface_spi_set_transfer(&chips[i].bus, count_transfer, &chips[i]) != 0 ||
+            bmp280_interface_spi_init(&chips[i].bus) != 0)
+        {
+            std::printf("sim chip %u setup failed\n", i);
+            return 1;
+        }
+        chips[i].sim.now_us = sim_now_us;
+        chips[i].sim.sleep_us = sim_sleep_us;
+    }
+
+    uint32_t failures = check_spi_read_batch(chips);
+    failures += check_bus_worker();
+
+    for (uint32_t i = 0; i < kChips; i++)
+        (void)bmp280_interface_spi_deinit(&chips[i].bus);
+    return failures == 0 ? 0 : 1;
+}
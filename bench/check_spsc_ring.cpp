@@ -0,0 +1,131 @@
+// SpscRing checks, one producer and one consumer thread per overflow
+// policy, the consumer stalling now and then so that the ring fills:
+//  - records come out in push order, and none is torn: every word of a
+//    record is derived from its sequence number, and the record spans more
+//    than one cache line
+//  - records delivered plus drops() equals records pushed; Block drops
+//    nothing, and both drop policies do drop
+//  - highWater() never exceeds capacity()
+// Exits non-zero on any difference.
+//
+//   make check
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include "SpscRing.h"
+
+static const size_t kCapacity = 16;
+static const uint64_t kRecords = 100000;
+
+// Word 0 is the sequence number, every other word is derived from it
+struct Record
+{
+    uint64_t words[12];
+};
+
+static const size_t kWords = sizeof(Record) / sizeof(uint64_t);
+
+static uint64_t derive(uint64_t seq, size_t i)
+{
+    return seq * 0x9E3779B97F4A7C15ull + i;
+}
+
+static Record make(uint64_t seq)
+{
+    Record r;
+    r.words[0] = seq;
+    for (size_t i = 1; i < kWords; i++)
+        r.words[i] = derive(seq, i);
+    return r;
+}
+
+static bool intact(const Record &r)
+{
+    for (size_t i = 1; i < kWords; i++)
+    {
+        if (r.words[i] != derive(r.words[0], i))
+            return false;
+    }
+    return true;
+}
+
+static const char *policyName(OverflowPolicy policy)
+{
+    switch (policy)
+    {
+    case OverflowPolicy::DropOldest:
+        return "drop-oldest";
+    case OverflowPolicy::DropNewest:
+        return "drop-newest";
+    default:
+        return "block";
+    }
+}
+
+static uint32_t check_policy(OverflowPolicy policy)
+{
+    SpscRing<Record> ring(kCapacity, policy);
+    std::atomic<bool> producing(true);
+    uint64_t rejected = 0;
+    uint32_t failures = 0;
+
+    std::thread producer([&] {
+        for (uint64_t seq = 1; seq <= kRecords; seq++)
+        {
+            if (!ring.push(make(seq)))
+                rejected++;
+        }
+        producing.store(false, std::memory_order_release);
+    });
+
+    // Sequence 0 is never pushed. A short stall now and then lets the
+    // producer fill the ring, and lap it under drop-oldest.
+    uint64_t last = 0;
+    uint64_t delivered = 0;
+    Record r;
+    for (;;)
+    {
+        bool done = !producing.load(std::memory_order_acquire);
+        while (ring.pop(r))
+        {
+            if (!intact(r) || r.words[0] <= last || r.words[0] > kRecords)
+                failures++;
+            last = r.words[0];
+            if (++delivered % 4096 == 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        if (done)
+            break;
+        std::this_thread::yield();
+    }
+    producer.join();
+
+    if (delivered + ring.drops() != kRecords)
+        failures++;
+    if (ring.highWater() > ring.capacity() || ring.highWater() == 0)
+        failures++;
+    if (policy == OverflowPolicy::DropNewest && rejected != ring.drops())
+        failures++;
+    if (policy != OverflowPolicy::DropNewest && rejected != 0)
+        failures++;
+    if ((policy == OverflowPolicy::Block) != (ring.drops() == 0))
+        failures++;
+    if (policy == OverflowPolicy::Block && last != kRecords)
+        failures++;
+
+    std::printf("%s: %llu pushed, %llu delivered, %llu dropped, high-water %llu of %zu, %u failures\n",
+                policyName(policy), (unsigned long long)kRecords, (unsigned long long)delivered,
+                (unsigned long long)ring.drops(), (unsigned long long)ring.highWater(), ring.capacity(), failures);
+    return failures;
+}
+
+int main()
+{
+    uint32_t failures = check_policy(OverflowPolicy::DropOldest);
+    failures += check_policy(OverflowPolicy::DropNewest);
+    failures += check_policy(OverflowPolicy::Block);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+// Timer wheel checks on a virtual clock, one 1 ms tick per poll() unless
+// noted, so every release is attributed to the tick it ran in:
+//  - periodic tasks at several rates run exactly on their k * period ticks
+//  - one-shot tasks either side of the level boundaries (64, 4096 and
+//    262144 ticks), armed at tick 0 and at an unaligned tick, run once on
+//    the tick they are due after cascading down
+//  - a task released again before its previous run is over skips that
+//    release, and a cancelled task never runs again
+// Exits non-zero on any difference.
+//
+//   make check
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "Clock.h"
+#include "TimerWheel.h"
+
+using std::chrono::milliseconds;
+
+static const milliseconds kTick(1);
+
+// Runs of one task, by the tick they happened in
+struct Runs
+{
+    VirtualClock *clock;
+    Clock::time_point start;
+    std::vector<uint64_t> ticks;
+
+    void record() { ticks.push_back((uint64_t)((clock->now() - start) / kTick)); }
+};
+
+static void step(VirtualClock &clock, TimerWheel &wheel, uint64_t ticks)
+{
+    for (uint64_t i = 0; i < ticks; i++)
+    {
+        clock.advance(kTick);
+        (void)wheel.poll();
+    }
+}
+
+static uint32_t check_multi_rate()
+{
+    static const uint64_t kPeriods[] = {1, 2, 3, 7, 63, 64, 65, 100, 4096};
+    static const uint64_t kTicks = 10000;
+    VirtualClock clock;
+    TimerWheel wheel(kTick, 0, clock);
+    std::vector<Runs> runs(sizeof(kPeriods) / sizeof(kPeriods[0]), Runs{&clock, clock.now(), {}});
+    uint32_t failures = 0;
+
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        Runs *r = &runs[i];
+        wheel.schedule(milliseconds(kPeriods[i]), [r] { r->record(); });
+    }
+    step(clock, wheel, kTicks);
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        if (runs[i].ticks.size() != kTicks / kPeriods[i])
+            failures++;
+        for (size_t k = 0; k < runs[i].ticks.size(); k++)
+        {
+            if (runs[i].ticks[k] != (k + 1) * kPeriods[i])
+                failures++;
+        }
+    }
+    if (wheel.skipped() != 0)
+        failures++;
+
+    std::printf("multi-rate: %zu tasks over %llu ticks, %llu releases, %u failures\n", runs.size(),
+                (unsigned long long)kTicks, (unsigned long long)wheel.fired(), failures);
+    return failures;
+}
+
+static uint32_t check_cascade()
+{
+    static const uint64_t kDelays[] = {1, 63, 64, 65, 127, 128, 129, 4095, 4096, 4097, 8191, 8192,
+                                       262143, 262144, 262145};
+    static const uint64_t kOffset = 37;         /* second batch armed off the slot grid */
+    static const size_t kCount = sizeof(kDelays) / sizeof(kDelays[0]);
+    VirtualClock clock;
+    TimerWheel wheel(kTick, 0, clock);
+    std::vector<Runs> runs(2 * kCount, Runs{&clock, clock.now(), {}});
+    uint32_t failures = 0;
+
+    for (size_t i = 0; i < kCount; i++)
+    {
+        Runs *r = &runs[i];
+        wheel.scheduleOnce(milliseconds(kDelays[i]), [r] { r->record(); });
+    }
+    step(clock, wheel, kOffset);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        Runs *r = &runs[kCount + i];
+        wheel.scheduleOnce(milliseconds(kDelays[i]), [r] { r->record(); });
+    }
+    step(clock, wheel, kDelays[kCount - 1] + kOffset + 64);
+
+    for (size_t i = 0; i < kCount; i++)
+    {
+        if (runs[i].ticks.size() != 1 || runs[i].ticks[0] != kDelays[i])
+            failures++;
+        if (runs[kCount + i].ticks.size() != 1 || runs[kCount + i].ticks[0] != kOffset + kDelays[i])
+            failures++;
+    }
+    if (wheel.tasks() != 0)
+        failures++;
+
+    std::printf("cascade: %zu one-shots up to %llu ticks, %u failures\n", runs.size(),
+                (unsigned long long)kDelays[kCount - 1] + kOffset, failures);
+    return failures;
+}
+
+static uint32_t check_overlap()
+{
+    VirtualClock clock;
+    TimerWheel wheel(kTick, 0, clock);
+    Runs every{&clock, clock.now(), {}}, third{&clock, clock.now(), {}}, cancelled{&clock, clock.now(), {}};
+    uint32_t failures = 0;
+
+    wheel.schedule(milliseconds(1), [&every] { every.record(); });
+    wheel.schedule(milliseconds(3), [&third] { third.record(); });
+    TimerWheel::TaskId id = wheel.schedule(milliseconds(2), [&cancelled] { cancelled.record(); });
+
+    // Ten ticks in one poll: the 1-tick task is released ten times and the
+    // 3-tick task three times, but each runs once
+    clock.advance(10 * kTick);
+    if (wheel.poll() != 3 || every.ticks.size() != 1 || third.ticks.size() != 1 || cancelled.ticks.size() != 1)
+        failures++;
+    if (wheel.fired() != 18 || wheel.skipped() != 15)
+        failures++;
+
+    // Caught up: every release runs again
+    if (!wheel.cancel(id) || wheel.cancel(id))
+        failures++;
+    step(clock, wheel, 6);
+    if (every.ticks.size() != 7 || third.ticks.size() != 3 || cancelled.ticks.size() != 1)
+        failures++;
+    if (every.ticks.back() != 16 || third.ticks.back() != 15)
+        failures++;
+
+    std::printf("overlap: %llu releases, %llu skipped, %u failures\n", (unsigned long long)wheel.fired(),
+                (unsigned long long)wheel.skipped(), failures);
+    return failures;
+}
+
+int main()
+{
+    uint32_t failures = check_multi_rate();
+    failures += check_cascade();
+    failures += check_overlap();
+    return failures == 0 ? 0 : 1;
+}
@@ -3,56 +3,141 @@
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <linux/spi/spidev.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <string.h>
+#include <errno.h>
+#include <time.h>
 
-static int i2c_fd = -1;
+/**
+ * @brief  interface iic bus context init
+ */
+uint8_t bmp280_interface_iic_bus_init(bmp280_interface_iic_bus_t *bus, uint8_t adapter)
+{
+    char path[32];
+
+    snprintf(path, sizeof(path), "/dev/i2c-%u", (unsigned)adapter);
+    return bmp280_interface_iic_bus_init_path(bus, path);
+}
+
+/**
+ * @brief  interface iic bus context init from a device path
+ */
+uint8_t bmp280_interface_iic_bus_init_path(bmp280_interface_iic_bus_t *bus, const char *path)
+{
+    if (bus == NULL || path == NULL || strlen(path) >= sizeof(bus->path))
+        return 1;
+    memset(bus, 0, sizeof(*bus));
+    strcpy(bus->path, path);
+    bus->fd = -1;
+    bus->slave_addr = -1;
+    bus->transfer = BMP280_INTERFACE_IIC_TRANSFER_RDWR;
+    return 0;
+}
+
+/**
+ * @brief  interface iic set the transfer path
+ */
+uint8_t bmp280_interface_iic_set_transfer(bmp280_interface_iic_bus_t *bus, bmp280_interface_iic_transfer_t transfer)
+{
+    if (bus == NULL)
+        return 1;
+    if (transfer != BMP280_INTERFACE_IIC_TRANSFER_RDWR &&
+        transfer != BMP280_INTERFACE_IIC_TRANSFER_LEGACY)
+        return 1;
+    bus->transfer = transfer;
+    return 0;
+}
+
+/**
+ * @brief  interface iic get the transfer path
+ */
+uint8_t bmp280_interface_iic_get_transfer(bmp280_interface_iic_bus_t *bus, bmp280_interface_iic_transfer_t *transfer)
+{
+    if (bus == NULL || transfer == NULL)
+        return 1;
+    *transfer = bus->transfer;
+    return 0;
+}
 
 /**
  * @brief  interface iic bus init
  */
-uint8_t bmp280_interface_iic_init(void)
+uint8_t bmp280_interface_iic_init(void *bus)
 {
-    i2c_fd = open("/dev/i2c-1", O_RDWR);
-    if (i2c_fd < 0)
-    {
-        perror("Failed to open /dev/i2c-1");
+    bmp280_interface_iic_bus_t *ctx = (bmp280_interface_iic_bus_t *)bus;
+
+    if (ctx == NULL)
         return 1;
+    if (ctx->users == 0)
+    {
+        ctx->fd = open(ctx->path, O_RDWR);
+        if (ctx->fd < 0)
+        {
+            fprintf(stderr, "Failed to open %s: %s\n", ctx->path, strerror(errno));
+            return 1;
+        }
+        ctx->slave_addr = -1;
+        printf("I2C bus %s opened, fd=%d\n", ctx->path, ctx->fd);
     }
-    printf("I2C bus opened, fd=%d\n", i2c_fd);
+    ctx->users++;
     return 0;
 }
 
 /**
  * @brief  interface iic bus deinit
  */
-uint8_t bmp280_interface_iic_deinit(void)
+uint8_t bmp280_interface_iic_deinit(void *bus)
 {
-    if (i2c_fd >= 0)
-        close(i2c_fd);
-    i2c_fd = -1;
+    bmp280_interface_iic_bus_t *ctx = (bmp280_interface_iic_bus_t *)bus;
+
+    if (ctx == NULL)
+        return 1;
+    if (ctx->users == 0)
+        return 0;
+    ctx->users--;
+    if (ctx->users == 0)
+    {
+        if (ctx->fd >= 0)
+            close(ctx->fd);
+        ctx->fd = -1;
+        ctx->slave_addr = -1;
+    }
     return 0;
 }
 
 /**
- * @brief  interface iic read
+ * @brief  select the slave address, skipping the ioctl when it is already selected
  */
-uint8_t bmp280_interface_iic_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+static uint8_t a_iic_select(bmp280_interface_iic_bus_t *ctx, uint8_t addr)
 {
-    if (i2c_fd < 0)
-        return 1;
-    if (ioctl(i2c_fd, I2C_SLAVE, addr) < 0)
+    if (ctx->slave_addr == addr)
+        return 0;
+    if (ioctl(ctx->fd, I2C_SLAVE, addr) < 0)
     {
         perror("Failed to set I2C slave address");
+        ctx->slave_addr = -1;
         return 1;
     }
-    if (write(i2c_fd, &reg, 1) != 1)
+    ctx->slave_addr = addr;
+    return 0;
+}
+
+/**
+ * @brief  legacy iic read: select the slave, write the register pointer, then read
+ */
+static uint8_t a_iic_read_legacy(bmp280_interface_iic_bus_t *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    if (a_iic_select(ctx, addr) != 0)
+        return 1;
+    if (write(ctx->fd, &reg, 1) != 1)
     {
         perror("Failed to write register address");
         return 1;
     }
-    if (read(i2c_fd, buf, len) != len)
+    if (read(ctx->fd, buf, len) != len)
     {
         perror("Failed to read from device");
         return 1;
@@ -61,21 +146,84 @@ uint8_t bmp280_interface_iic_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint1
 }
 
 /**
- * @brief  interface iic write
+ * @brief  legacy iic write: select the slave, then write register and data
  */
-uint8_t bmp280_interface_iic_write(uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+static uint8_t a_iic_write_legacy(bmp280_interface_iic_bus_t *ctx, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
 {
-    if (i2c_fd < 0)
+    uint8_t tmp[BMP280_INTERFACE_WRITE_LEN + 1];
+
+    if (len > BMP280_INTERFACE_WRITE_LEN || a_iic_select(ctx, addr) != 0)
         return 1;
-    if (ioctl(i2c_fd, I2C_SLAVE, addr) < 0)
+    tmp[0] = reg;
+    memcpy(tmp + 1, buf, len);
+    if (write(ctx->fd, tmp, len + 1) != len + 1)
     {
-        perror("Failed to set I2C slave address");
+        perror("Failed to write to device");
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  interface iic read
+ * @note   register pointer write and data read go out as one repeated-start transfer
+ */
+uint8_t bmp280_interface_iic_read(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    bmp280_interface_iic_bus_t *ctx = (bmp280_interface_iic_bus_t *)bus;
+
+    if (ctx == NULL || ctx->fd < 0)
+        return 1;
+    if (ctx->transfer == BMP280_INTERFACE_IIC_TRANSFER_LEGACY)
+        return a_iic_read_legacy(ctx, addr, reg, buf, len);
+
+    struct i2c_msg msgs[2];
+    msgs[0].addr = addr;
+    msgs[0].flags = 0;
+    msgs[0].len = 1;
+    msgs[0].buf = &reg;
+    msgs[1].addr = addr;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = len;
+    msgs[1].buf = buf;
+
+    struct i2c_rdwr_ioctl_data xfer;
+    xfer.msgs = msgs;
+    xfer.nmsgs = 2;
+    if (ioctl(ctx->fd, I2C_RDWR, &xfer) != 2)
+    {
+        perror("Failed to read from device");
         return 1;
     }
-    uint8_t tmp[len + 1];
+    return 0;
+}
+
+/**
+ * @brief  interface iic write
+ */
+uint8_t bmp280_interface_iic_write(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    bmp280_interface_iic_bus_t *ctx = (bmp280_interface_iic_bus_t *)bus;
+    uint8_t tmp[BMP280_INTERFACE_WRITE_LEN + 1];
+
+    if (ctx == NULL || ctx->fd < 0 || len > BMP280_INTERFACE_WRITE_LEN)
+        return 1;
+    if (ctx->transfer == BMP280_INTERFACE_IIC_TRANSFER_LEGACY)
+        return a_iic_write_legacy(ctx, addr, reg, buf, len);
+
     tmp[0] = reg;
     memcpy(tmp + 1, buf, len);
-    if (write(i2c_fd, tmp, len + 1) != len + 1)
+
+    struct i2c_msg msg;
+    msg.addr = addr;
+    msg.flags = 0;
+    msg.len = len + 1;
+    msg.buf = tmp;
+
+    struct i2c_rdwr_ioctl_data xfer;
+    xfer.msgs = &msg;
+    xfer.nmsgs = 1;
+    if (ioctl(ctx->fd, I2C_RDWR, &xfer) != 1)
     {
         perror("Failed to write to device");
         return 1;
@@ -83,11 +231,274 @@ uint8_t bmp280_interface_iic_write(uint8_t addr, uint8_t reg, uint8_t *buf, uint
     return 0;
 }
 
-/* SPI not used on Linux */
-uint8_t bmp280_interface_spi_init(void) { return 0; }
-uint8_t bmp280_interface_spi_deinit(void) { return 0; }
-uint8_t bmp280_interface_spi_read(uint8_t reg, uint8_t *buf, uint16_t len) { return 0; }
-uint8_t bmp280_interface_spi_write(uint8_t reg, uint8_t *buf, uint16_t len) { return 0; }
+/**
+ * @brief  interface iic batched read
+ */
+uint8_t bmp280_interface_iic_read_batch(void *bus, bmp280_interface_iic_read_t *reads, uint32_t count)
+{
+    bmp280_interface_iic_bus_t *ctx = (bmp280_interface_iic_bus_t *)bus;
+    struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    struct i2c_rdwr_ioctl_data xfer;
+    uint8_t res = 0;
+    uint32_t start;
+    uint32_t n;
+    uint32_t i;
+
+    if (ctx == NULL || reads == NULL || ctx->fd < 0)
+        return 1;
+    for (start = 0; start < count; start += n)
+    {
+        n = count - start;
+        if (n > I2C_RDWR_IOCTL_MAX_MSGS / 2)
+            n = I2C_RDWR_IOCTL_MAX_MSGS / 2;
+        if (ctx->transfer == BMP280_INTERFACE_IIC_TRANSFER_RDWR)
+        {
+            for (i = 0; i < n; i++)
+            {
+                bmp280_interface_iic_read_t *r = &reads[start + i];
+
+                msgs[2 * i].addr = r->addr;
+                msgs[2 * i].flags = 0;
+                msgs[2 * i].len = 1;
+                msgs[2 * i].buf = &r->reg;
+                msgs[2 * i + 1].addr = r->addr;
+                msgs[2 * i + 1].flags = I2C_M_RD;
+                msgs[2 * i + 1].len = r->len;
+                msgs[2 * i + 1].buf = r->buf;
+            }
+            xfer.msgs = msgs;
+            xfer.nmsgs = 2 * n;
+            if (ioctl(ctx->fd, I2C_RDWR, &xfer) == (int)(2 * n))
+            {
+                for (i = 0; i < n; i++)
+                    reads[start + i].result = 0;
+                continue;
+            }
+        }
+
+        /* legacy path, or one device nacked the combined transfer */
+        for (i = 0; i < n; i++)
+        {
+            bmp280_interface_iic_read_t *r = &reads[start + i];
+
+            r->result = bmp280_interface_iic_read(ctx, r->addr, r->reg, r->buf, r->len);
+            res |= r->result;
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief  interface spi bus context init
+ */
+uint8_t bmp280_interface_spi_bus_init(bmp280_interface_spi_bus_t *bus, uint8_t bus_num, uint8_t cs)
+{
+    char path[32];
+
+    snprintf(path, sizeof(path), "/dev/spidev%u.%u", (unsigned)bus_num, (unsigned)cs);
+    return bmp280_interface_spi_bus_init_path(bus, path);
+}
+
+/**
+ * @brief  interface spi bus context init from a device path
+ */
+uint8_t bmp280_interface_spi_bus_init_path(bmp280_interface_spi_bus_t *bus, const char *path)
+{
+    if (bus == NULL || path == NULL || strlen(path) >= sizeof(bus->path))
+        return 1;
+    memset(bus, 0, sizeof(*bus));
+    strcpy(bus->path, path);
+    bus->fd = -1;
+    bus->speed_hz = 10000000;
+    bus->mode = SPI_MODE_0;
+    return 0;
+}
+
+/**
+ * @brief  interface spi set the transfer hook
+ */
+uint8_t bmp280_interface_spi_set_transfer(bmp280_interface_spi_bus_t *bus, bmp280_interface_spi_transfer_t transfer, void *ctx)
+{
+    if (bus == NULL || bus->users != 0)
+        return 1;
+    bus->transfer = transfer;
+    bus->transfer_ctx = ctx;
+    return 0;
+}
+
+/**
+ * @brief  interface spi bus init
+ */
+uint8_t bmp280_interface_spi_init(void *bus)
+{
+    bmp280_interface_spi_bus_t *ctx = (bmp280_interface_spi_bus_t *)bus;
+    uint8_t bits = 8;
+
+    if (ctx == NULL)
+        return 1;
+    if (ctx->users == 0 && ctx->transfer == NULL)
+    {
+        ctx->fd = open(ctx->path, O_RDWR);
+        if (ctx->fd < 0)
+        {
+            fprintf(stderr, "Failed to open %s: %s\n", ctx->path, strerror(errno));
+            return 1;
+        }
+        if (ioctl(ctx->fd, SPI_IOC_WR_MODE, &ctx->mode) < 0 ||
+            ioctl(ctx->fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+            ioctl(ctx->fd, SPI_IOC_WR_MAX_SPEED_HZ, &ctx->speed_hz) < 0)
+        {
+            perror("Failed to configure SPI device");
+            close(ctx->fd);
+            ctx->fd = -1;
+            return 1;
+        }
+        printf("SPI device %s opened, fd=%d, %u Hz\n", ctx->path, ctx->fd, (unsigned)ctx->speed_hz);
+    }
+    ctx->users++;
+    return 0;
+}
+
+/**
+ * @brief  interface spi bus deinit
+ */
+uint8_t bmp280_interface_spi_deinit(void *bus)
+{
+    bmp280_interface_spi_bus_t *ctx = (bmp280_interface_spi_bus_t *)bus;
+
+    if (ctx == NULL)
+        return 1;
+    if (ctx->users == 0)
+        return 0;
+    ctx->users--;
+    if (ctx->users == 0)
+    {
+        if (ctx->fd >= 0)
+            close(ctx->fd);
+        ctx->fd = -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  run transfers on one device, through the hook or as one SPI_IOC_MESSAGE
+ */
+static uint8_t a_spi_transfer(bmp280_interface_spi_bus_t *ctx, const bmp280_interface_spi_xfer_t *xfers, uint32_t count)
+{
+    struct spi_ioc_transfer msgs[BMP280_INTERFACE_SPI_BATCH_MAX];
+    uint32_t i;
+
+    if (ctx->transfer != NULL)
+        return ctx->transfer(ctx->transfer_ctx, xfers, count);
+    if (ctx->fd < 0 || count > BMP280_INTERFACE_SPI_BATCH_MAX)
+        return 1;
+
+    memset(msgs, 0, sizeof(msgs[0]) * count);
+    for (i = 0; i < count; i++)
+    {
+        msgs[i].tx_buf = (unsigned long)xfers[i].tx;
+        msgs[i].rx_buf = (unsigned long)xfers[i].rx;
+        msgs[i].len = xfers[i].len;
+        msgs[i].speed_hz = ctx->speed_hz;
+        msgs[i].bits_per_word = 8;
+        msgs[i].cs_change = (i + 1 < count) ? 1 : 0;
+    }
+    if (ioctl(ctx->fd, SPI_IOC_MESSAGE(count), msgs) < 0)
+    {
+        perror("Failed to transfer on SPI device");
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  interface spi read
+ * @note   the first received byte is clocked in during the address byte and dropped
+ */
+uint8_t bmp280_interface_spi_read(void *bus, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    bmp280_interface_spi_bus_t *ctx = (bmp280_interface_spi_bus_t *)bus;
+    bmp280_interface_spi_xfer_t xfer;
+    uint8_t tx[BMP280_INTERFACE_READ_LEN + 1];
+    uint8_t rx[BMP280_INTERFACE_READ_LEN + 1];
+
+    if (ctx == NULL || len > BMP280_INTERFACE_READ_LEN)
+        return 1;
+    memset(tx, 0, (size_t)len + 1);
+    tx[0] = reg;
+    xfer.tx = tx;
+    xfer.rx = rx;
+    xfer.len = (uint32_t)len + 1;
+    if (a_spi_transfer(ctx, &xfer, 1) != 0)
+        return 1;
+    memcpy(buf, rx + 1, len);
+    return 0;
+}
+
+/**
+ * @brief  interface spi write
+ */
+uint8_t bmp280_interface_spi_write(void *bus, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    bmp280_interface_spi_bus_t *ctx = (bmp280_interface_spi_bus_t *)bus;
+    bmp280_interface_spi_xfer_t xfer;
+    uint8_t tx[2 * BMP280_INTERFACE_WRITE_LEN];
+    uint16_t i;
+
+    if (ctx == NULL || len == 0 || len > BMP280_INTERFACE_WRITE_LEN)
+        return 1;
+    for (i = 0; i < len; i++)
+    {
+        tx[2 * i] = (uint8_t)((reg + i) & 0x7F);
+        tx[2 * i + 1] = buf[i];
+    }
+    xfer.tx = tx;
+    xfer.rx = NULL;
+    xfer.len = 2 * len;
+    return a_spi_transfer(ctx, &xfer, 1);
+}
+
+/**
+ * @brief  interface spi batched read
+ * @note   spidev has one chip select per file descriptor, so reads of different
+ *         devices cannot share an ioctl; each run of reads on one device does
+ */
+uint8_t bmp280_interface_spi_read_batch(const bmp280_interface_spi_read_t *reads, uint32_t count)
+{
+    uint8_t tx[BMP280_INTERFACE_SPI_BATCH_MAX][BMP280_INTERFACE_SPI_BATCH_LEN + 1];
+    uint8_t rx[BMP280_INTERFACE_SPI_BATCH_MAX][BMP280_INTERFACE_SPI_BATCH_LEN + 1];
+    bmp280_interface_spi_xfer_t xfers[BMP280_INTERFACE_SPI_BATCH_MAX];
+    uint32_t start;
+    uint32_t n;
+    uint32_t i;
+
+    if (reads == NULL)
+        return 1;
+    for (start = 0; start < count; start += n)
+    {
+        /* collect the run of reads on the same device */
+        n = 0;
+        while (start + n < count && n < BMP280_INTERFACE_SPI_BATCH_MAX &&
+               reads[start + n].bus == reads[start].bus)
+        {
+            const bmp280_interface_spi_read_t *r = &reads[start + n];
+
+            if (r->bus == NULL || r->len > BMP280_INTERFACE_SPI_BATCH_LEN)
+                return 1;
+            memset(tx[n], 0, (size_t)r->len + 1);
+            tx[n][0] = (uint8_t)(r->reg | 0x80);
+            xfers[n].tx = tx[n];
+            xfers[n].rx = rx[n];
+            xfers[n].len = (uint32_t)r->len + 1;
+            n++;
+        }
+        if (a_spi_transfer(reads[start].bus, xfers, n) != 0)
+            return 1;
+        for (i = 0; i < n; i++)
+            memcpy(reads[start + i].buf, rx[i] + 1, reads[start + i].len);
+    }
+    return 0;
+}
 
 /**
  * @brief  delay in ms
@@ -97,6 +508,19 @@ void bmp280_interface_delay_ms(uint32_t ms)
     usleep(ms * 1000);
 }
 
+/**
+ * @brief  delay in us
+ */
+void bmp280_interface_delay_us(uint32_t us)
+{
+    struct timespec ts;
+
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (long)(us % 1000000) * 1000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, &ts) == EINTR)
+        ;
+}
+
 /**
  * @brief  debug print
  */
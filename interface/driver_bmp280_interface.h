@@ -51,25 +51,162 @@ extern "C"{
  */
 
 /**
- * @brief  interface iic bus init
- * @return status code
- *         - 0 success
- *         - 1 iic init failed
- * @note   none
+ * @brief bmp280 interface iic transfer enumeration definition
  */
-uint8_t bmp280_interface_iic_init(void);
+typedef enum
+{
+    BMP280_INTERFACE_IIC_TRANSFER_RDWR   = 0x00,        /**< combined repeated-start transfer through I2C_RDWR */
+    BMP280_INTERFACE_IIC_TRANSFER_LEGACY = 0x01,        /**< I2C_SLAVE, then separate write and read calls */
+} bmp280_interface_iic_transfer_t;
 
 /**
- * @brief  interface iic bus deinit
- * @return status code
- *         - 0 success
- *         - 1 iic deinit failed
- * @note   none
+ * @brief bmp280 interface iic bus context structure definition
  */
-uint8_t bmp280_interface_iic_deinit(void);
+typedef struct bmp280_interface_iic_bus_s
+{
+    char path[32];                                  /**< adapter device path, e.g. /dev/i2c-1 */
+    int fd;                                         /**< adapter file descriptor, -1 when closed */
+    int slave_addr;                                 /**< currently selected I2C_SLAVE address, -1 when unknown */
+    uint32_t users;                                 /**< number of handles that initialized the bus */
+    bmp280_interface_iic_transfer_t transfer;       /**< transfer path */
+} bmp280_interface_iic_bus_t;
+
+/**
+ * @brief bmp280 interface iic batched read structure definition
+ */
+typedef struct bmp280_interface_iic_read_s
+{
+    uint8_t addr;                                   /**< iic device address */
+    uint8_t reg;                                    /**< first register */
+    uint8_t *buf;                                   /**< data buffer */
+    uint16_t len;                                   /**< data length */
+    uint8_t result;                                 /**< status code of this read, set by the batch */
+} bmp280_interface_iic_read_t;
+
+/**
+ * @brief bmp280 interface spi transfer structure definition
+ */
+typedef struct bmp280_interface_spi_xfer_s
+{
+    const uint8_t *tx;                              /**< transmit buffer, NULL sends zeros */
+    uint8_t *rx;                                    /**< receive buffer, NULL discards */
+    uint32_t len;                                   /**< transfer length in bytes */
+} bmp280_interface_spi_xfer_t;
+
+/**
+ * @brief bmp280 interface spi transfer hook definition
+ * @note  runs count full-duplex transfers, chip select is released between them
+ */
+typedef uint8_t (*bmp280_interface_spi_transfer_t)(void *ctx, const bmp280_interface_spi_xfer_t *xfers, uint32_t count);
+
+/**
+ * @brief bmp280 interface spi bus context structure definition
+ */
+typedef struct bmp280_interface_spi_bus_s
+{
+    char path[32];                                  /**< spidev device path, e.g. /dev/spidev0.0 */
+    int fd;                                         /**< device file descriptor, -1 when closed */
+    uint32_t users;                                 /**< number of handles that initialized the bus */
+    uint32_t speed_hz;                              /**< clock rate */
+    uint8_t mode;                                   /**< spi mode, the chip supports 0 and 3 */
+    bmp280_interface_spi_transfer_t transfer;       /**< transfer hook, NULL uses spidev */
+    void *transfer_ctx;                             /**< transfer hook context */
+} bmp280_interface_spi_bus_t;
+
+/**
+ * @brief bmp280 interface spi batched read structure definition
+ */
+typedef struct bmp280_interface_spi_read_s
+{
+    bmp280_interface_spi_bus_t *bus;                /**< device to read from */
+    uint8_t reg;                                    /**< first register */
+    uint8_t *buf;                                   /**< data buffer */
+    uint16_t len;                                   /**< data length */
+} bmp280_interface_spi_read_t;
+
+/**
+ * @brief max number of reads and bytes per read in one batch message
+ */
+#define BMP280_INTERFACE_SPI_BATCH_MAX        16
+#define BMP280_INTERFACE_SPI_BATCH_LEN        32
+
+/**
+ * @brief longest single read, enough for the warm start burst of 0x88 - 0xF5
+ */
+#define BMP280_INTERFACE_READ_LEN             128
+
+/**
+ * @brief longest register write, every control register is written on its own
+ */
+#define BMP280_INTERFACE_WRITE_LEN            1
+
+/**
+ * @brief     interface iic bus context init
+ * @param[in] *bus pointer to an iic bus context
+ * @param[in] adapter adapter number, selects /dev/i2c-<adapter>
+ * @return    status code
+ *            - 0 success
+ *            - 1 bus context init failed
+ * @note      does not open the adapter, that happens on the first bmp280_interface_iic_init
+ */
+uint8_t bmp280_interface_iic_bus_init(bmp280_interface_iic_bus_t *bus, uint8_t adapter);
+
+/**
+ * @brief     interface iic bus context init from a device path
+ * @param[in] *bus pointer to an iic bus context
+ * @param[in] *path adapter device path
+ * @return    status code
+ *            - 0 success
+ *            - 1 bus context init failed
+ * @note      none
+ */
+uint8_t bmp280_interface_iic_bus_init_path(bmp280_interface_iic_bus_t *bus, const char *path);
+
+/**
+ * @brief     interface iic set the transfer path
+ * @param[in] *bus pointer to an iic bus context
+ * @param[in] transfer iic transfer path
+ * @return    status code
+ *            - 0 success
+ *            - 1 set transfer failed
+ * @note      the default is BMP280_INTERFACE_IIC_TRANSFER_RDWR, the legacy path is kept for benchmarking
+ */
+uint8_t bmp280_interface_iic_set_transfer(bmp280_interface_iic_bus_t *bus, bmp280_interface_iic_transfer_t transfer);
+
+/**
+ * @brief      interface iic get the transfer path
+ * @param[in]  *bus pointer to an iic bus context
+ * @param[out] *transfer pointer to an iic transfer path buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get transfer failed
+ * @note       none
+ */
+uint8_t bmp280_interface_iic_get_transfer(bmp280_interface_iic_bus_t *bus, bmp280_interface_iic_transfer_t *transfer);
+
+/**
+ * @brief     interface iic bus init
+ * @param[in] *bus pointer to a bmp280_interface_iic_bus_t context
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      the adapter is opened once and shared by every handle linked to the same context
+ */
+uint8_t bmp280_interface_iic_init(void *bus);
+
+/**
+ * @brief     interface iic bus deinit
+ * @param[in] *bus pointer to a bmp280_interface_iic_bus_t context
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      the adapter is closed when the last user deinitializes it
+ */
+uint8_t bmp280_interface_iic_deinit(void *bus);
 
 /**
  * @brief      interface iic bus read
+ * @param[in]  *bus pointer to a bmp280_interface_iic_bus_t context
  * @param[in]  addr iic device write address
  * @param[in]  reg iic register address
  * @param[out] *buf pointer to a data buffer
@@ -79,10 +216,11 @@ uint8_t bmp280_interface_iic_deinit(void);
  *             - 1 read failed
  * @note       none
  */
-uint8_t bmp280_interface_iic_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+uint8_t bmp280_interface_iic_read(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
 
 /**
  * @brief     interface iic bus write
+ * @param[in] *bus pointer to a bmp280_interface_iic_bus_t context
  * @param[in] addr iic device write address
  * @param[in] reg iic register address
  * @param[in] *buf pointer to a data buffer
@@ -90,51 +228,120 @@ uint8_t bmp280_interface_iic_read(uint8_t addr, uint8_t reg, uint8_t *buf, uint1
  * @return    status code
  *            - 0 success
  *            - 1 write failed
+ * @note      at most BMP280_INTERFACE_WRITE_LEN data bytes
+ */
+uint8_t bmp280_interface_iic_write(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief      interface iic batched read
+ * @param[in]  *bus pointer to a bmp280_interface_iic_bus_t context
+ * @param[in]  *reads pointer to a read list
+ * @param[in]  count number of reads
+ * @return     status code
+ *             - 0 success
+ *             - 1 at least one read failed
+ * @note       the reads go out back to back as repeated-start transfers of one I2C_RDWR
+ *             ioctl, so several sensors on an adapter cost one system call; if the
+ *             ioctl fails the reads are retried one by one to find the failing ones
+ */
+uint8_t bmp280_interface_iic_read_batch(void *bus, bmp280_interface_iic_read_t *reads, uint32_t count);
+
+/**
+ * @brief     interface spi bus context init
+ * @param[in] *bus pointer to an spi bus context
+ * @param[in] bus_num spi controller number
+ * @param[in] cs chip select, selects /dev/spidev<bus_num>.<cs>
+ * @return    status code
+ *            - 0 success
+ *            - 1 bus context init failed
+ * @note      10 MHz in mode 0, does not open the device
+ */
+uint8_t bmp280_interface_spi_bus_init(bmp280_interface_spi_bus_t *bus, uint8_t bus_num, uint8_t cs);
+
+/**
+ * @brief     interface spi bus context init from a device path
+ * @param[in] *bus pointer to an spi bus context
+ * @param[in] *path spidev device path
+ * @return    status code
+ *            - 0 success
+ *            - 1 bus context init failed
  * @note      none
  */
-uint8_t bmp280_interface_iic_write(uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+uint8_t bmp280_interface_spi_bus_init_path(bmp280_interface_spi_bus_t *bus, const char *path);
 
 /**
- * @brief  interface spi bus init
- * @return status code
- *         - 0 success
- *         - 1 spi init failed
- * @note   none
+ * @brief     interface spi set the transfer hook
+ * @param[in] *bus pointer to an spi bus context
+ * @param[in] transfer transfer hook, NULL restores spidev
+ * @param[in] *ctx hook context
+ * @return    status code
+ *            - 0 success
+ *            - 1 set transfer failed
+ * @note      with a hook linked no device is opened, so a simulated chip can
+ *            stand in for the hardware behind the same framing
  */
-uint8_t bmp280_interface_spi_init(void);
+uint8_t bmp280_interface_spi_set_transfer(bmp280_interface_spi_bus_t *bus, bmp280_interface_spi_transfer_t transfer, void *ctx);
 
 /**
- * @brief  interface spi bus deinit
- * @return status code
- *         - 0 success
- *         - 1 spi deinit failed
- * @note   none
+ * @brief     interface spi bus init
+ * @param[in] *bus pointer to a bmp280_interface_spi_bus_t context
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi init failed
+ * @note      the device is opened once and shared by every handle linked to the same context
+ */
+uint8_t bmp280_interface_spi_init(void *bus);
+
+/**
+ * @brief     interface spi bus deinit
+ * @param[in] *bus pointer to a bmp280_interface_spi_bus_t context
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi deinit failed
+ * @note      the device is closed when the last user deinitializes it
  */
-uint8_t bmp280_interface_spi_deinit(void);
+uint8_t bmp280_interface_spi_deinit(void *bus);
 
 /**
  * @brief      interface spi bus read
- * @param[in]  reg register address
+ * @param[in]  *bus pointer to a bmp280_interface_spi_bus_t context
+ * @param[in]  reg register address with the read bit set
  * @param[out] *buf pointer to a data buffer
  * @param[in]  len length of data buffer
  * @return     status code
  *             - 0 success
  *             - 1 read failed
- * @note       none
+ * @note       address byte and data phase go out as one transfer, at most
+ *             BMP280_INTERFACE_READ_LEN bytes
  */
-uint8_t bmp280_interface_spi_read(uint8_t reg, uint8_t *buf, uint16_t len);
+uint8_t bmp280_interface_spi_read(void *bus, uint8_t reg, uint8_t *buf, uint16_t len);
 
 /**
  * @brief     interface spi bus write
- * @param[in] reg register address
+ * @param[in] *bus pointer to a bmp280_interface_spi_bus_t context
+ * @param[in] reg register address with the read bit clear
  * @param[in] *buf pointer to a data buffer
  * @param[in] len length of data buffer
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      none
+ * @note      the chip does not auto-increment on spi writes, so every data byte
+ *            is sent after its own address byte within one transfer; an empty
+ *            write or one longer than BMP280_INTERFACE_WRITE_LEN is rejected
  */
-uint8_t bmp280_interface_spi_write(uint8_t reg, uint8_t *buf, uint16_t len);
+uint8_t bmp280_interface_spi_write(void *bus, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     interface spi batched read
+ * @param[in] *reads pointer to a read list
+ * @param[in] count number of reads
+ * @return    status code
+ *            - 0 success
+ *            - 1 read failed
+ * @note      consecutive reads of the same device go out as one SPI_IOC_MESSAGE,
+ *            the read bit is set here, at most BMP280_INTERFACE_SPI_BATCH_LEN bytes per read
+ */
+uint8_t bmp280_interface_spi_read_batch(const bmp280_interface_spi_read_t *reads, uint32_t count);
 
 /**
  * @brief     interface delay ms
@@ -143,6 +350,13 @@ uint8_t bmp280_interface_spi_write(uint8_t reg, uint8_t *buf, uint16_t len);
  */
 void bmp280_interface_delay_ms(uint32_t ms);
 
+/**
+ * @brief     interface delay us
+ * @param[in] us time
+ * @note      none
+ */
+void bmp280_interface_delay_us(uint32_t us);
+
 /**
  * @brief     interface print format data
  * @param[in] fmt format data
@@ -0,0 +1,436 @@
+#include "driver_bmp280_interface_sim.h"
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+/**
+ * @brief calibration example from the datasheet, section 3.12
+ */
+static const bmp280_calibration_t gs_sim_calibration = {27504, 26435, -1000, 36477, -10685, 3024,
+                                                        2855, 140, -7, 15500, -14600, 6000};
+
+/**
+ * @brief oversampling factor table, indexed by the osrs register field
+ */
+static const uint32_t gs_sim_oversampling[8] = {0, 1, 2, 4, 8, 16, 16, 16};
+
+/**
+ * @brief standby time table in microseconds, indexed by the t_sb register field
+ */
+static const uint32_t gs_sim_standby_us[8] = {500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000};
+
+/**
+ * @brief  current time of the simulated chip
+ */
+static uint64_t a_sim_now(bmp280_interface_sim_t *sim)
+{
+    struct timespec ts;
+
+    if (sim->now_us != NULL)
+        return sim->now_us(sim->now_ctx);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/**
+ * @brief  typical conversion time for a ctrl meas value
+ * @note   t_measure = 1 ms + 2 ms * osrs_t + (2 ms * osrs_p + 0.5 ms), shorter
+ *         than the maximum the driver waits for
+ */
+static uint32_t a_sim_conversion_us(uint8_t ctrl_meas)
+{
+    uint32_t osrs_t = gs_sim_oversampling[(ctrl_meas >> 5) & 0x07];
+    uint32_t osrs_p = gs_sim_oversampling[(ctrl_meas >> 2) & 0x07];
+    uint32_t us = 1000 + 2000 * osrs_t;
+
+    if (osrs_p != 0)
+        us += 2000 * osrs_p + 500;
+    return us;
+}
+
+/**
+ * @brief  signed noise in [-noise_lsb, noise_lsb]
+ */
+static int32_t a_sim_noise(bmp280_interface_sim_t *sim)
+{
+    if (sim->noise_lsb == 0)
+        return 0;
+    sim->seed = sim->seed * 1664525u + 1013904223u;
+    return (int32_t)((sim->seed >> 8) % (2 * sim->noise_lsb + 1)) - (int32_t)sim->noise_lsb;
+}
+
+/**
+ * @brief  raw value as the adc reports it for an osrs register field
+ * @note   a skipped measurement reads 0x80000, x1 gives 16 bit and every
+ *         further step one more bit of resolution
+ */
+static uint32_t a_sim_quantize(int32_t raw, uint8_t osrs)
+{
+    uint32_t shift;
+
+    if (osrs == 0)
+        return 0x80000;
+    if (raw < 0)
+        raw = 0;
+    if (raw > 0xFFFFF)
+        raw = 0xFFFFF;
+    shift = osrs >= 5 ? 0 : 5 - osrs;
+    return ((uint32_t)raw >> shift) << shift;
+}
+
+/**
+ * @brief  store raw values in the data registers
+ */
+static void a_sim_store(bmp280_interface_sim_t *sim, uint32_t pressure_raw, uint32_t temperature_raw)
+{
+    sim->regs[0xF7] = (uint8_t)(pressure_raw >> 12);
+    sim->regs[0xF8] = (uint8_t)(pressure_raw >> 4);
+    sim->regs[0xF9] = (uint8_t)((pressure_raw & 0x0F) << 4);
+    sim->regs[0xFA] = (uint8_t)(temperature_raw >> 12);
+    sim->regs[0xFB] = (uint8_t)(temperature_raw >> 4);
+    sim->regs[0xFC] = (uint8_t)((temperature_raw & 0x0F) << 4);
+}
+
+/**
+ * @brief  finish a conversion: latch a noisy sample of the environment
+ */
+static void a_sim_latch(bmp280_interface_sim_t *sim)
+{
+    uint8_t ctrl_meas = sim->regs[0xF4];
+    int32_t t = (int32_t)sim->temperature_raw + a_sim_noise(sim);
+    int32_t p = (int32_t)sim->pressure_raw + a_sim_noise(sim);
+
+    a_sim_store(sim, a_sim_quantize(p, (ctrl_meas >> 2) & 0x07), a_sim_quantize(t, (ctrl_meas >> 5) & 0x07));
+    sim->conversions++;
+}
+
+/**
+ * @brief  advance the chip to the current time and refresh the status register
+ */
+static void a_sim_update(bmp280_interface_sim_t *sim)
+{
+    uint64_t now = a_sim_now(sim);
+    uint8_t ctrl_meas = sim->regs[0xF4];
+    uint32_t conversion_us = a_sim_conversion_us(ctrl_meas);
+    uint8_t status = 0;
+
+    if (now < sim->nvm_done_us)
+        status |= BMP280_STATUS_IM_UPDATE;
+    if (sim->mode == BMP280_MODE_FORCED)
+    {
+        if (!sim->stuck_measuring && now >= sim->conversion_start_us + conversion_us)
+        {
+            a_sim_latch(sim);
+            sim->mode = BMP280_MODE_SLEEP;
+            sim->regs[0xF4] &= (uint8_t)~0x03;
+        }
+        else
+        {
+            status |= BMP280_STATUS_MEASURING;
+        }
+    }
+    else if (sim->mode == BMP280_MODE_NORMAL)
+    {
+        /* a cycle is a conversion followed by the standby time */
+        uint64_t period = conversion_us + gs_sim_standby_us[(sim->regs[0xF5] >> 5) & 0x07];
+        uint64_t elapsed = now - sim->conversion_start_us;
+
+        if (elapsed >= conversion_us)
+        {
+            uint64_t done = (elapsed - conversion_us) / period + 1;
+
+            if (done > sim->cycles)
+            {
+                a_sim_latch(sim);
+                sim->cycles = done;
+            }
+        }
+        if (elapsed % period < conversion_us)
+            status |= BMP280_STATUS_MEASURING;
+    }
+    if (sim->stuck_measuring)
+        status |= BMP280_STATUS_MEASURING;
+    sim->regs[0xF3] = status;
+}
+
+/**
+ * @brief  start a transaction: account it, wait out the bus latency and apply faults
+ */
+static uint8_t a_sim_begin(bmp280_interface_sim_t *sim, uint32_t bytes)
+{
+    uint64_t wait_us = sim->latency_us + (uint64_t)sim->byte_us * bytes;
+
+    sim->transactions++;
+    if (wait_us != 0 && sim->sleep_us != NULL)
+    {
+        sim->sleep_us(sim->now_ctx, wait_us);
+    }
+    else if (wait_us != 0)
+    {
+        struct timespec ts;
+
+        ts.tv_sec = (time_t)(wait_us / 1000000);
+        ts.tv_nsec = (long)(wait_us % 1000000) * 1000;
+        while (clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, &ts) == EINTR)
+            ;
+    }
+    if (sim->nack_next != 0)
+    {
+        sim->nack_next--;
+        sim->nacks++;
+        return 1;
+    }
+    if (sim->nack_every != 0 && sim->transactions % sim->nack_every == 0)
+    {
+        sim->nacks++;
+        return 1;
+    }
+    a_sim_update(sim);
+    return 0;
+}
+
+/**
+ * @brief  register write with the side effects of the chip
+ */
+static void a_sim_write_reg(bmp280_interface_sim_t *sim, uint8_t reg, uint8_t value)
+{
+    switch (reg)
+    {
+        case 0xE0 :
+        {
+            if (value != 0xB6)
+                break;
+            sim->regs[0xF4] = 0;
+            sim->regs[0xF5] = 0;
+            sim->mode = BMP280_MODE_SLEEP;
+            a_sim_store(sim, 0x80000, 0x80000);
+            sim->nvm_done_us = a_sim_now(sim) + 2000;
+            a_sim_update(sim);
+            break;
+        }
+        case 0xF4 :
+        {
+            uint8_t mode = value & 0x03;
+
+            sim->regs[0xF4] = value;
+            if (mode == 0x01 || mode == 0x02)
+            {
+                sim->mode = BMP280_MODE_FORCED;
+                sim->conversion_start_us = a_sim_now(sim);
+            }
+            else if (mode == BMP280_MODE_NORMAL)
+            {
+                if (sim->mode != BMP280_MODE_NORMAL)
+                {
+                    sim->mode = BMP280_MODE_NORMAL;
+                    sim->conversion_start_us = a_sim_now(sim);
+                    sim->cycles = 0;
+                }
+            }
+            else
+            {
+                sim->mode = BMP280_MODE_SLEEP;
+            }
+            a_sim_update(sim);
+            break;
+        }
+        case 0xF5 :
+        {
+            sim->regs[0xF5] = value;
+            break;
+        }
+        default :
+        {
+            break;                                  /* read-only */
+        }
+    }
+}
+
+/**
+ * @brief  interface sim init
+ */
+uint8_t bmp280_interface_sim_init(bmp280_interface_sim_t *sim, uint8_t addr)
+{
+    if (sim == NULL)
+        return 1;
+    memset(sim, 0, sizeof(*sim));
+    sim->addr = addr;
+    sim->regs[0xD0] = 0x58;
+    sim->noise_lsb = 16;
+    sim->seed = 1;
+    a_sim_store(sim, 0x80000, 0x80000);
+    (void)bmp280_interface_sim_set_calibration(sim, &gs_sim_calibration);
+    return bmp280_interface_sim_set_environment(sim, 25.0f, 101325.0f);
+}
+
+/**
+ * @brief  interface sim set the calibration
+ */
+uint8_t bmp280_interface_sim_set_calibration(bmp280_interface_sim_t *sim, const bmp280_calibration_t *calibration)
+{
+    uint16_t words[12];
+    uint32_t i;
+
+    if (sim == NULL || calibration == NULL)
+        return 1;
+    words[0] = calibration->t1;
+    words[1] = (uint16_t)calibration->t2;
+    words[2] = (uint16_t)calibration->t3;
+    words[3] = calibration->p1;
+    words[4] = (uint16_t)calibration->p2;
+    words[5] = (uint16_t)calibration->p3;
+    words[6] = (uint16_t)calibration->p4;
+    words[7] = (uint16_t)calibration->p5;
+    words[8] = (uint16_t)calibration->p6;
+    words[9] = (uint16_t)calibration->p7;
+    words[10] = (uint16_t)calibration->p8;
+    words[11] = (uint16_t)calibration->p9;
+    for (i = 0; i < 12; i++)
+    {
+        sim->regs[0x88 + 2 * i] = (uint8_t)words[i];
+        sim->regs[0x89 + 2 * i] = (uint8_t)(words[i] >> 8);
+    }
+    sim->calibration = *calibration;
+    return 0;
+}
+
+/**
+ * @brief  interface sim set the environment
+ * @note   temperature rises and pressure falls monotonically with the raw value,
+ *         so a bisection over the 20 bit range finds the raw values
+ */
+uint8_t bmp280_interface_sim_set_environment(bmp280_interface_sim_t *sim, float temperature_c, float pressure_pa)
+{
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t mid;
+
+    if (sim == NULL)
+        return 1;
+    lo = 0;
+    hi = 0xFFFFF;
+    while (lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if (bmp280_compensate_fixed(&sim->calibration, mid, 0x80000).temperature_centi_c < temperature_c * 100.0f)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    sim->temperature_raw = lo;
+
+    lo = 0;
+    hi = 0xFFFFF;
+    while (lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if (bmp280_compensate_fixed(&sim->calibration, sim->temperature_raw, mid).pressure_q24_8 > pressure_pa * 256.0f)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    sim->pressure_raw = lo;
+    return 0;
+}
+
+/**
+ * @brief  interface sim iic bus init
+ */
+uint8_t bmp280_interface_sim_iic_init(void *bus)
+{
+    bmp280_interface_sim_t *sim = (bmp280_interface_sim_t *)bus;
+
+    if (sim == NULL)
+        return 1;
+    sim->users++;
+    return 0;
+}
+
+/**
+ * @brief  interface sim iic bus deinit
+ */
+uint8_t bmp280_interface_sim_iic_deinit(void *bus)
+{
+    bmp280_interface_sim_t *sim = (bmp280_interface_sim_t *)bus;
+
+    if (sim == NULL)
+        return 1;
+    if (sim->users != 0)
+        sim->users--;
+    return 0;
+}
+
+/**
+ * @brief  interface sim iic read
+ * @note   the register pointer auto-increments across the burst
+ */
+uint8_t bmp280_interface_sim_iic_read(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    bmp280_interface_sim_t *sim = (bmp280_interface_sim_t *)bus;
+    uint16_t i;
+
+    if (sim == NULL || sim->users == 0 || addr != sim->addr)
+        return 1;
+    if (a_sim_begin(sim, 2u + len) != 0)
+        return 1;
+    for (i = 0; i < len; i++)
+        buf[i] = sim->regs[(uint8_t)(reg + i)];
+    return 0;
+}
+
+/**
+ * @brief  interface sim iic write
+ */
+uint8_t bmp280_interface_sim_iic_write(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    bmp280_interface_sim_t *sim = (bmp280_interface_sim_t *)bus;
+    uint16_t i;
+
+    if (sim == NULL || sim->users == 0 || addr != sim->addr)
+        return 1;
+    if (a_sim_begin(sim, 2u + len) != 0)
+        return 1;
+    for (i = 0; i < len; i++)
+        a_sim_write_reg(sim, (uint8_t)(reg + i), buf[i]);
+    return 0;
+}
+
+/**
+ * @brief  interface sim spi transfer hook
+ * @note   bit 7 of the control byte selects read, the register address is the
+ *         control byte with bit 7 set; writes are control and data byte pairs
+ */
+uint8_t bmp280_interface_sim_spi_transfer(void *ctx, const bmp280_interface_spi_xfer_t *xfers, uint32_t count)
+{
+    bmp280_interface_sim_t *sim = (bmp280_interface_sim_t *)ctx;
+    uint32_t i;
+    uint32_t j;
+
+    if (sim == NULL || xfers == NULL)
+        return 1;
+    for (i = 0; i < count; i++)
+    {
+        const bmp280_interface_spi_xfer_t *x = &xfers[i];
+
+        if (x->tx == NULL || x->len == 0)
+            return 1;
+        if (a_sim_begin(sim, x->len) != 0)
+            return 1;
+        if (x->tx[0] & 0x80)
+        {
+            if (x->rx == NULL)
+                continue;
+            x->rx[0] = 0;
+            for (j = 1; j < x->len; j++)
+                x->rx[j] = sim->regs[(uint8_t)(x->tx[0] + j - 1)];
+        }
+        else
+        {
+            for (j = 0; j + 1 < x->len; j += 2)
+                a_sim_write_reg(sim, (uint8_t)(x->tx[j] | 0x80), x->tx[j + 1]);
+            if (x->rx != NULL)
+                memset(x->rx, 0, x->len);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_bmp280_interface_sim.h
+ * @brief     driver bmp280 simulated chip interface header file
+ * @version   1.0.0
+ * @author    Atmospheric Monitor
+ * @date      2026-10-17
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author               <th>Description
+ * <tr><td>2026/10/17  <td>1.0      <td>Atmospheric Monitor  <td>simulated bus backend
+ * </table>
+ */
+
+#ifndef DRIVER_BMP280_INTERFACE_SIM_H
+#define DRIVER_BMP280_INTERFACE_SIM_H
+
+#include "driver_bmp280_interface.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @addtogroup bmp280_interface_driver
+ * @{
+ */
+
+/**
+ * @brief bmp280 simulated chip structure definition
+ * @note  an in-process register model: chip id, soft reset with the nvm copy,
+ *        calibration nvm, ctrl meas and config, forced and normal mode timing
+ *        and synthetic adc output for a configurable environment; the fault
+ *        and latency fields may be changed at any time
+ */
+typedef struct bmp280_interface_sim_s
+{
+    uint8_t addr;                                   /**< iic address the chip answers on */
+    uint8_t regs[256];                              /**< register file */
+    uint8_t mode;                                   /**< running mode, 0 sleep, 1 forced, 3 normal */
+    uint64_t nvm_done_us;                           /**< end of the nvm copy after a reset */
+    uint64_t conversion_start_us;                   /**< forced conversion or normal cycle start */
+    uint64_t cycles;                                /**< normal mode cycles latched since the cycle start */
+    uint64_t conversions;                           /**< conversions latched so far */
+    uint32_t temperature_raw;                       /**< raw temperature of the environment */
+    uint32_t pressure_raw;                          /**< raw pressure of the environment */
+    uint32_t noise_lsb;                             /**< peak noise added to every conversion, in 20 bit lsb */
+    uint32_t seed;                                  /**< noise generator state */
+    uint32_t latency_us;                            /**< bus latency per transaction */
+    uint32_t byte_us;                               /**< bus latency per transferred byte */
+    uint32_t nack_every;                            /**< nack every nth transaction, 0 never */
+    uint32_t nack_next;                             /**< nack the next n transactions */
+    uint8_t stuck_measuring;                        /**< status reports measuring and forced conversions never end */
+    uint64_t transactions;                          /**< transactions seen */
+    uint64_t nacks;                                 /**< transactions failed */
+    uint64_t (*now_us)(void *ctx);                  /**< time source, NULL uses CLOCK_MONOTONIC */
+    void (*sleep_us)(void *ctx, uint64_t us);       /**< bus latency wait, NULL uses clock_nanosleep */
+    void *now_ctx;                                  /**< time source and wait context */
+    bmp280_calibration_t calibration;               /**< calibration in the nvm */
+    uint32_t users;                                 /**< number of handles that initialized the bus */
+} bmp280_interface_sim_t;
+
+/**
+ * @brief     interface sim init
+ * @param[in] *sim pointer to a simulated chip
+ * @param[in] addr iic address the chip answers on
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      powers the chip up with the datasheet example calibration at 25 degC
+ *            and 1013.25 hPa, 16 lsb of noise (a few Pa) and no latency or faults
+ */
+uint8_t bmp280_interface_sim_init(bmp280_interface_sim_t *sim, uint8_t addr);
+
+/**
+ * @brief     interface sim set the calibration
+ * @param[in] *sim pointer to a simulated chip
+ * @param[in] *calibration pointer to a bmp280 calibration structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 set calibration failed
+ * @note      rewrites the nvm and the environment raw values
+ */
+uint8_t bmp280_interface_sim_set_calibration(bmp280_interface_sim_t *sim, const bmp280_calibration_t *calibration);
+
+/**
+ * @brief     interface sim set the environment
+ * @param[in] *sim pointer to a simulated chip
+ * @param[in] temperature_c temperature in degC
+ * @param[in] pressure_pa pressure in Pa
+ * @return    status code
+ *            - 0 success
+ *            - 1 set environment failed
+ * @note      the raw values are found by inverting the integer compensation,
+ *            conversions started afterwards report them
+ */
+uint8_t bmp280_interface_sim_set_environment(bmp280_interface_sim_t *sim, float temperature_c, float pressure_pa);
+
+/**
+ * @brief     interface sim iic bus init
+ * @param[in] *bus pointer to a bmp280_interface_sim_t
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t bmp280_interface_sim_iic_init(void *bus);
+
+/**
+ * @brief     interface sim iic bus deinit
+ * @param[in] *bus pointer to a bmp280_interface_sim_t
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t bmp280_interface_sim_iic_deinit(void *bus);
+
+/**
+ * @brief      interface sim iic bus read
+ * @param[in]  *bus pointer to a bmp280_interface_sim_t
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       another address or an injected fault nacks
+ */
+uint8_t bmp280_interface_sim_iic_read(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     interface sim iic bus write
+ * @param[in] *bus pointer to a bmp280_interface_sim_t
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      another address or an injected fault nacks
+ */
+uint8_t bmp280_interface_sim_iic_write(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     interface sim spi transfer hook
+ * @param[in] *ctx pointer to a bmp280_interface_sim_t
+ * @param[in] *xfers pointer to a transfer list
+ * @param[in] count number of transfers
+ * @return    status code
+ *            - 0 success
+ *            - 1 transfer failed
+ * @note      link with bmp280_interface_spi_set_transfer, decodes the spi framing
+ */
+uint8_t bmp280_interface_sim_spi_transfer(void *ctx, const bmp280_interface_spi_xfer_t *xfers, uint32_t count);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,418 @@
+#include "driver_bmp280_interface_trace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+/**
+ * @brief trace file header
+ */
+static const uint8_t gs_trace_magic[4] = {'B', 'M', 'P', 'T'};
+#define TRACE_VERSION        1
+#define TRACE_HEADER_LEN     8
+
+/**
+ * @brief  monotonic time in us
+ */
+static uint64_t a_trace_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/**
+ * @brief  append an unsigned LEB128 varint
+ */
+static size_t a_trace_put_varint(uint8_t *out, uint64_t value)
+{
+    size_t n = 0;
+
+    while (value >= 0x80)
+    {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+/**
+ * @brief  parse an unsigned LEB128 varint, 0 on a truncated trace
+ */
+static uint8_t a_trace_get_varint(const uint8_t *data, size_t size, size_t *pos, uint64_t *value)
+{
+    uint32_t shift = 0;
+
+    *value = 0;
+    while (*pos < size && shift < 64)
+    {
+        uint8_t b = data[(*pos)++];
+
+        *value |= (uint64_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0)
+            return 1;
+        shift += 7;
+    }
+    return 0;
+}
+
+/**
+ * @brief  write one record
+ */
+static void a_trace_record(bmp280_interface_record_t *rec, uint8_t flags, uint64_t now,
+                           uint8_t addr, uint8_t reg, const uint8_t *buf, uint16_t len)
+{
+    uint8_t head[1 + 10 + 2 + 3];
+    size_t n = 0;
+    uint16_t payload = ((flags & BMP280_INTERFACE_TRACE_FAILED) && !(flags & BMP280_INTERFACE_TRACE_WRITE)) ? 0 : len;
+
+    if (rec->file == NULL)
+        return;
+    head[n++] = flags;
+    n += a_trace_put_varint(&head[n], now - rec->last_us);
+    head[n++] = addr;
+    head[n++] = reg;
+    n += a_trace_put_varint(&head[n], len);
+    if (fwrite(head, 1, n, rec->file) != n || fwrite(buf, 1, payload, rec->file) != payload || fflush(rec->file) != 0)
+    {
+        fprintf(stderr, "Failed to write trace: %s\n", strerror(errno));
+        fclose(rec->file);
+        rec->file = NULL;
+        return;
+    }
+    rec->last_us = now;
+    rec->records++;
+}
+
+/**
+ * @brief  interface record open
+ */
+uint8_t bmp280_interface_record_open(bmp280_interface_record_t *rec, const char *path, void *bus,
+                                     uint8_t (*iic_init)(void *bus), uint8_t (*iic_deinit)(void *bus),
+                                     uint8_t (*iic_read)(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len),
+                                     uint8_t (*iic_write)(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len))
+{
+    uint8_t header[TRACE_HEADER_LEN] = {0};
+
+    if (rec == NULL || path == NULL || iic_init == NULL || iic_deinit == NULL || iic_read == NULL || iic_write == NULL)
+        return 1;
+    memset(rec, 0, sizeof(*rec));
+    rec->file = fopen(path, "wb");
+    if (rec->file == NULL)
+    {
+        fprintf(stderr, "Failed to open %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    memcpy(header, gs_trace_magic, sizeof(gs_trace_magic));
+    header[4] = TRACE_VERSION;
+    if (fwrite(header, 1, sizeof(header), rec->file) != sizeof(header))
+    {
+        fclose(rec->file);
+        rec->file = NULL;
+        return 1;
+    }
+    rec->last_us = a_trace_now_us();
+    rec->bus = bus;
+    rec->iic_init = iic_init;
+    rec->iic_deinit = iic_deinit;
+    rec->iic_read = iic_read;
+    rec->iic_write = iic_write;
+    return 0;
+}
+
+/**
+ * @brief  interface record close
+ */
+uint8_t bmp280_interface_record_close(bmp280_interface_record_t *rec)
+{
+    if (rec == NULL)
+        return 1;
+    if (rec->file != NULL && fclose(rec->file) != 0)
+    {
+        rec->file = NULL;
+        return 1;
+    }
+    rec->file = NULL;
+    return 0;
+}
+
+/**
+ * @brief  interface record iic bus init
+ */
+uint8_t bmp280_interface_record_iic_init(void *bus)
+{
+    bmp280_interface_record_t *rec = (bmp280_interface_record_t *)bus;
+
+    if (rec == NULL || rec->iic_init == NULL)
+        return 1;
+    return rec->iic_init(rec->bus);
+}
+
+/**
+ * @brief  interface record iic bus deinit
+ */
+uint8_t bmp280_interface_record_iic_deinit(void *bus)
+{
+    bmp280_interface_record_t *rec = (bmp280_interface_record_t *)bus;
+
+    if (rec == NULL || rec->iic_deinit == NULL)
+        return 1;
+    return rec->iic_deinit(rec->bus);
+}
+
+/**
+ * @brief  interface record iic bus read
+ */
+uint8_t bmp280_interface_record_iic_read(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    bmp280_interface_record_t *rec = (bmp280_interface_record_t *)bus;
+    uint64_t now;
+    uint8_t res;
+
+    if (rec == NULL || rec->iic_read == NULL)
+        return 1;
+    now = a_trace_now_us();
+    res = rec->iic_read(rec->bus, addr, reg, buf, len);
+    a_trace_record(rec, res != 0 ? BMP280_INTERFACE_TRACE_FAILED : 0, now, addr, reg, buf, len);
+    return res;
+}
+
+/**
+ * @brief  interface record iic bus write
+ */
+uint8_t bmp280_interface_record_iic_write(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    bmp280_interface_record_t *rec = (bmp280_interface_record_t *)bus;
+    uint64_t now;
+    uint8_t res;
+
+    if (rec == NULL || rec->iic_write == NULL)
+        return 1;
+    now = a_trace_now_us();
+    res = rec->iic_write(rec->bus, addr, reg, buf, len);
+    a_trace_record(rec, (uint8_t)(BMP280_INTERFACE_TRACE_WRITE | (res != 0 ? BMP280_INTERFACE_TRACE_FAILED : 0)),
+                   now, addr, reg, buf, len);
+    return res;
+}
+
+/**
+ * @brief  parsed trace record
+ */
+typedef struct trace_entry_s
+{
+    uint8_t flags;
+    uint64_t time_us;
+    uint8_t addr;
+    uint8_t reg;
+    uint16_t len;
+    const uint8_t *payload;
+    size_t next;
+} trace_entry_t;
+
+/**
+ * @brief  parse the next record without consuming it
+ */
+static uint8_t a_trace_peek(const bmp280_interface_replay_t *rep, trace_entry_t *entry)
+{
+    size_t pos = rep->pos;
+    uint64_t delta;
+    uint64_t len;
+    uint16_t payload;
+
+    if (pos >= rep->size)
+        return 0;
+    entry->flags = rep->data[pos++];
+    if (!a_trace_get_varint(rep->data, rep->size, &pos, &delta) || pos + 2 > rep->size)
+        return 0;
+    entry->time_us = rep->trace_us + delta;
+    entry->addr = rep->data[pos++];
+    entry->reg = rep->data[pos++];
+    if (!a_trace_get_varint(rep->data, rep->size, &pos, &len) || len > 0xFFFF)
+        return 0;
+    entry->len = (uint16_t)len;
+    payload = ((entry->flags & BMP280_INTERFACE_TRACE_FAILED) &&
+               !(entry->flags & BMP280_INTERFACE_TRACE_WRITE)) ? 0 : entry->len;
+    if (pos + payload > rep->size)
+        return 0;
+    entry->payload = &rep->data[pos];
+    entry->next = pos + payload;
+    return 1;
+}
+
+/**
+ * @brief  match a call against the next record, pace it and consume it
+ * @note   written is the data of a write call, NULL for a read; write records
+ *         always carry their payload, so it is compared once kind, address,
+ *         register and length have matched
+ */
+static uint8_t a_trace_replay(bmp280_interface_replay_t *rep, const uint8_t *written, uint8_t addr, uint8_t reg,
+                              uint16_t len, trace_entry_t *entry)
+{
+    if (!a_trace_peek(rep, entry) || ((entry->flags & BMP280_INTERFACE_TRACE_WRITE) != 0) != (written != NULL) ||
+        entry->addr != addr || entry->reg != reg || entry->len != len ||
+        (written != NULL && memcmp(entry->payload, written, len) != 0))
+    {
+        rep->divergences++;
+        return 0;
+    }
+    if (rep->realtime)
+    {
+        uint64_t due = rep->start_us + entry->time_us;
+        uint64_t now = a_trace_now_us();
+
+        if (due > now)
+        {
+            struct timespec ts;
+
+            ts.tv_sec = (time_t)((due - now) / 1000000);
+            ts.tv_nsec = (long)((due - now) % 1000000) * 1000;
+            while (clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, &ts) == EINTR)
+                ;
+        }
+    }
+    rep->pos = entry->next;
+    rep->trace_us = entry->time_us;
+    rep->records++;
+    return 1;
+}
+
+/**
+ * @brief  interface replay open
+ */
+uint8_t bmp280_interface_replay_open(bmp280_interface_replay_t *rep, const char *path, uint8_t realtime)
+{
+    FILE *f;
+    long size;
+
+    if (rep == NULL || path == NULL)
+        return 1;
+    memset(rep, 0, sizeof(*rep));
+    f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "Failed to open %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    if (fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < TRACE_HEADER_LEN || fseek(f, 0, SEEK_SET) != 0)
+    {
+        fclose(f);
+        return 1;
+    }
+    rep->data = (uint8_t *)malloc((size_t)size);
+    if (rep->data == NULL || fread(rep->data, 1, (size_t)size, f) != (size_t)size ||
+        memcmp(rep->data, gs_trace_magic, sizeof(gs_trace_magic)) != 0 || rep->data[4] != TRACE_VERSION)
+    {
+        fprintf(stderr, "Invalid trace %s\n", path);
+        fclose(f);
+        free(rep->data);
+        rep->data = NULL;
+        return 1;
+    }
+    fclose(f);
+    rep->size = (size_t)size;
+    rep->pos = TRACE_HEADER_LEN;
+    rep->realtime = realtime;
+    rep->start_us = a_trace_now_us();
+    return 0;
+}
+
+/**
+ * @brief  interface replay close
+ */
+uint8_t bmp280_interface_replay_close(bmp280_interface_replay_t *rep)
+{
+    if (rep == NULL)
+        return 1;
+    free(rep->data);
+    rep->data = NULL;
+    rep->size = 0;
+    rep->pos = 0;
+    return 0;
+}
+
+/**
+ * @brief  interface replay check the end of the trace
+ */
+uint8_t bmp280_interface_replay_done(const bmp280_interface_replay_t *rep)
+{
+    trace_entry_t entry;
+
+    return (rep == NULL || !a_trace_peek(rep, &entry)) ? 1 : 0;
+}
+
+/**
+ * @brief  interface replay get the address of the next transaction
+ */
+uint8_t bmp280_interface_replay_peek_addr(const bmp280_interface_replay_t *rep, uint8_t *addr)
+{
+    trace_entry_t entry;
+
+    if (rep == NULL || addr == NULL || !a_trace_peek(rep, &entry))
+        return 1;
+    *addr = entry.addr;
+    return 0;
+}
+
+/**
+ * @brief  interface replay iic bus init
+ */
+uint8_t bmp280_interface_replay_iic_init(void *bus)
+{
+    return bus == NULL ? 1 : 0;
+}
+
+/**
+ * @brief  interface replay iic bus deinit
+ */
+uint8_t bmp280_interface_replay_iic_deinit(void *bus)
+{
+    (void)bus;
+    return 0;
+}
+
+/**
+ * @brief  interface replay iic bus read
+ */
+uint8_t bmp280_interface_replay_iic_read(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    bmp280_interface_replay_t *rep = (bmp280_interface_replay_t *)bus;
+    trace_entry_t entry;
+
+    if (rep == NULL || !a_trace_replay(rep, NULL, addr, reg, len, &entry))
+        return 1;
+    if (entry.flags & BMP280_INTERFACE_TRACE_FAILED)
+        return 1;
+    memcpy(buf, entry.payload, len);
+    return 0;
+}
+
+/**
+ * @brief  interface replay iic bus write
+ */
+uint8_t bmp280_interface_replay_iic_write(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    bmp280_interface_replay_t *rep = (bmp280_interface_replay_t *)bus;
+    trace_entry_t entry;
+
+    if (rep == NULL || buf == NULL || !a_trace_replay(rep, buf, addr, reg, len, &entry))
+        return 1;
+    return (entry.flags & BMP280_INTERFACE_TRACE_FAILED) ? 1 : 0;
+}
+
+/**
+ * @brief  interface replay delay ms
+ */
+void bmp280_interface_replay_delay_ms(uint32_t ms)
+{
+    (void)ms;
+}
+
+/**
+ * @brief  interface replay delay us
+ */
+void bmp280_interface_replay_delay_us(uint32_t us)
+{
+    (void)us;
+}
@@ -0,0 +1,284 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      driver_bmp280_interface_trace.h
+ * @brief     driver bmp280 trace record and replay interface header file
+ * @version   1.0.0
+ * @author    Atmospheric Monitor
+ * @date      2026-10-17
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author               <th>Description
+ * <tr><td>2026/10/17  <td>1.0      <td>Atmospheric Monitor  <td>trace record and replay backend
+ * </table>
+ */
+
+#ifndef DRIVER_BMP280_INTERFACE_TRACE_H
+#define DRIVER_BMP280_INTERFACE_TRACE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "driver_bmp280_interface.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @addtogroup bmp280_interface_driver
+ * @{
+ */
+
+/**
+ * @brief bmp280 interface trace record flag enumeration definition
+ * @note  a trace file is the magic "BMPT", a version byte and three reserved
+ *        bytes, followed by records of: flags, time since the previous record
+ *        in us as a varint, address, register, payload length as a varint and
+ *        the payload; a failed read carries no payload
+ */
+typedef enum
+{
+    BMP280_INTERFACE_TRACE_WRITE  = (1 << 0),        /**< write transaction, otherwise read */
+    BMP280_INTERFACE_TRACE_FAILED = (1 << 1),        /**< the transaction returned an error */
+} bmp280_interface_trace_flag_t;
+
+/**
+ * @brief bmp280 interface trace recorder structure definition
+ */
+typedef struct bmp280_interface_record_s
+{
+    FILE *file;                                                                     /**< trace file */
+    uint64_t last_us;                                                               /**< time of the previous record */
+    uint64_t records;                                                               /**< records written */
+    void *bus;                                                                      /**< recorded bus context */
+    uint8_t (*iic_init)(void *bus);                                                 /**< recorded iic_init */
+    uint8_t (*iic_deinit)(void *bus);                                               /**< recorded iic_deinit */
+    uint8_t (*iic_read)(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);     /**< recorded iic_read */
+    uint8_t (*iic_write)(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);    /**< recorded iic_write */
+} bmp280_interface_record_t;
+
+/**
+ * @brief bmp280 interface trace replayer structure definition
+ */
+typedef struct bmp280_interface_replay_s
+{
+    uint8_t *data;                  /**< whole trace file */
+    size_t size;                    /**< trace size */
+    size_t pos;                     /**< offset of the next record */
+    uint64_t trace_us;              /**< trace time of the next record */
+    uint64_t start_us;              /**< replay start, for real-time pacing */
+    uint8_t realtime;               /**< pace transactions by their recorded time */
+    uint64_t records;               /**< records replayed */
+    uint64_t divergences;           /**< calls that did not match the next record */
+} bmp280_interface_replay_t;
+
+/**
+ * @brief     interface record open
+ * @param[in] *rec pointer to a trace recorder
+ * @param[in] *path trace file path
+ * @param[in] *bus bus context of the recorded callbacks
+ * @param[in] *iic_init recorded iic_init
+ * @param[in] *iic_deinit recorded iic_deinit
+ * @param[in] *iic_read recorded iic_read
+ * @param[in] *iic_write recorded iic_write
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      link the bmp280_interface_record_iic_* callbacks with rec as the bus
+ */
+uint8_t bmp280_interface_record_open(bmp280_interface_record_t *rec, const char *path, void *bus,
+                                     uint8_t (*iic_init)(void *bus), uint8_t (*iic_deinit)(void *bus),
+                                     uint8_t (*iic_read)(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len),
+                                     uint8_t (*iic_write)(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len));
+
+/**
+ * @brief     interface record close
+ * @param[in] *rec pointer to a trace recorder
+ * @return    status code
+ *            - 0 success
+ *            - 1 close failed
+ * @note      none
+ */
+uint8_t bmp280_interface_record_close(bmp280_interface_record_t *rec);
+
+/**
+ * @brief     interface record iic bus init
+ * @param[in] *bus pointer to a bmp280_interface_record_t
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      passed through, not recorded
+ */
+uint8_t bmp280_interface_record_iic_init(void *bus);
+
+/**
+ * @brief     interface record iic bus deinit
+ * @param[in] *bus pointer to a bmp280_interface_record_t
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic deinit failed
+ * @note      passed through, not recorded
+ */
+uint8_t bmp280_interface_record_iic_deinit(void *bus);
+
+/**
+ * @brief      interface record iic bus read
+ * @param[in]  *bus pointer to a bmp280_interface_record_t
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       every record is flushed, so a trace survives a crash
+ */
+uint8_t bmp280_interface_record_iic_read(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     interface record iic bus write
+ * @param[in] *bus pointer to a bmp280_interface_record_t
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      every record is flushed, so a trace survives a crash
+ */
+uint8_t bmp280_interface_record_iic_write(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     interface replay open
+ * @param[in] *rep pointer to a trace replayer
+ * @param[in] *path trace file path
+ * @param[in] realtime 1 paces transactions by their recorded time, 0 runs as fast as possible
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      the whole trace is loaded into memory
+ */
+uint8_t bmp280_interface_replay_open(bmp280_interface_replay_t *rep, const char *path, uint8_t realtime);
+
+/**
+ * @brief     interface replay close
+ * @param[in] *rep pointer to a trace replayer
+ * @return    status code
+ *            - 0 success
+ *            - 1 close failed
+ * @note      none
+ */
+uint8_t bmp280_interface_replay_close(bmp280_interface_replay_t *rep);
+
+/**
+ * @brief     interface replay check the end of the trace
+ * @param[in] *rep pointer to a trace replayer
+ * @return    1 when every record was replayed, otherwise 0
+ * @note      none
+ */
+uint8_t bmp280_interface_replay_done(const bmp280_interface_replay_t *rep);
+
+/**
+ * @brief      interface replay get the address of the next transaction
+ * @param[in]  *rep pointer to a trace replayer
+ * @param[out] *addr pointer to an address buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 trace is empty or done
+ * @note       the device a replayed handle has to be set up for
+ */
+uint8_t bmp280_interface_replay_peek_addr(const bmp280_interface_replay_t *rep, uint8_t *addr);
+
+/**
+ * @brief     interface replay iic bus init
+ * @param[in] *bus pointer to a bmp280_interface_replay_t
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic init failed
+ * @note      none
+ */
+uint8_t bmp280_interface_replay_iic_init(void *bus);
+
+/**
+ * @brief     interface replay iic bus deinit
+ * @param[in] *bus pointer to a bmp280_interface_replay_t
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t bmp280_interface_replay_iic_deinit(void *bus);
+
+/**
+ * @brief      interface replay iic bus read
+ * @param[in]  *bus pointer to a bmp280_interface_replay_t
+ * @param[in]  addr iic device write address
+ * @param[in]  reg iic register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of the data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       returns the recorded data and result; a call that does not match
+ *             the next record fails without consuming it and counts a divergence
+ */
+uint8_t bmp280_interface_replay_iic_read(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     interface replay iic bus write
+ * @param[in] *bus pointer to a bmp280_interface_replay_t
+ * @param[in] addr iic device write address
+ * @param[in] reg iic register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of the data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the written data has to match the record
+ */
+uint8_t bmp280_interface_replay_iic_write(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     interface replay delay ms
+ * @param[in] ms time
+ * @note      does not wait, recorded timing comes from the trace
+ */
+void bmp280_interface_replay_delay_ms(uint32_t ms);
+
+/**
+ * @brief     interface replay delay us
+ * @param[in] us time
+ * @note      does not wait, recorded timing comes from the trace
+ */
+void bmp280_interface_replay_delay_us(uint32_t us);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,134 +2,586 @@
 #include <unistd.h>
 #include "driver_bmp280.h"
 #include "driver_bmp280_interface.h"
+#include "driver_bmp280_interface_sim.h"
+#include "driver_bmp280_interface_trace.h"
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include "ForcedSampler.h"
+#include "StreamReader.h"
+#include "WarmCache.h"
+#include "Discovery.h"
+#include "BusWorker.h"
+#include "PeriodicScheduler.h"
+#include "Realtime.h"
+#include "Clock.h"
+#include "SpscRing.h"
+#include <atomic>
+#include <thread>
+#include <ctime>
+#include <csignal>
+#include <memory>
 
-int main()
+// Failed stream reads in a row before the stream gives up
+static const int kMaxStreamFailures = 16;
+
+// Set by SIGINT/SIGTERM; the loops finish the current sample and shut down
+static volatile std::sig_atomic_t gs_stop = 0;
+
+static void onStopSignal(int)
+{
+    gs_stop = 1;
+}
+
+static void printReading(const BMP280Reading &reading)
+{
+#ifdef BMP280_FIXED_POINT
+    // Integer formatting keeps the fixed-point build free of float math:
+    // centi-degrees and Q24.8 Pa are split into whole and fractional parts
+    int32_t t = reading.temperature_centi_c;
+    uint32_t centi_hpa = (uint32_t)(((uint64_t)reading.pressure_q24_8 + 128) >> 8);
+    char temp[16];
+    char press[16];
+    std::snprintf(temp, sizeof(temp), "%s%d.%02d", t < 0 ? "-" : "", (int)(std::abs(t) / 100), (int)(std::abs(t) % 100));
+    std::snprintf(press, sizeof(press), "%u.%02u", (unsigned)(centi_hpa / 100), (unsigned)(centi_hpa % 100));
+    std::cout << "Temp (raw): " << reading.temperature_raw << " => " << temp << " °C, "
+              << "Press (raw): " << reading.pressure_raw << " => " << press << " hPa" << std::endl;
+#else
+    std::cout << "Temp (raw): " << reading.temperature_raw << " => " << reading.temperature_c << " °C, "
+              << "Press (raw): " << reading.pressure_raw << " => " << reading.pressure_pa / 100.0f << " hPa" << std::endl;
+#endif
+}
+
+// Printing side of the acquisition/sink split. Readings cross a lock-free
+// ring to a thread of their own, so a slow terminal or disk never delays
+// the next measurement; what happens when the sink falls behind is the
+// ring's overflow policy.
+class ReadingSink
+{
+public:
+    ReadingSink(size_t depth, OverflowPolicy policy)
+        : ring_(depth, policy), acquiring_(true), thread_(&ReadingSink::run, this)
+    {
+    }
+
+    ~ReadingSink() { stop(); }
+
+    void push(const BMP280Reading &reading) { ring_.push(reading); }
+
+    // Print what is still queued, then report drops and the high-water mark
+    void stop()
+    {
+        if (!thread_.joinable())
+            return;
+        acquiring_.store(false, std::memory_order_release);
+        thread_.join();
+        std::cout << "Sink: " << ring_.drops() << " readings dropped, high-water " << ring_.highWater() << " of "
+                  << ring_.capacity() << std::endl;
+    }
+
+private:
+    void run()
+    {
+        BMP280Reading reading;
+
+        for (;;)
+        {
+            bool last = !acquiring_.load(std::memory_order_acquire);
+            while (ring_.pop(reading))
+                printReading(reading);
+            if (last)
+                return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    SpscRing<BMP280Reading> ring_;
+    std::atomic<bool> acquiring_;
+    std::thread thread_;
+};
+
+// Persist the applied configuration so the next start can skip the cold init
+static void saveWarmState(bmp280_handle_t *handle, const char *bus_path, const char *path)
+{
+    bmp280_warm_state_t state;
+
+    if (path == nullptr)
+        return;
+    if (bmp280_get_warm_state(handle, &state) != 0 || !saveWarmCache(path, bus_path, handle->iic_addr, state))
+        std::cerr << "Warning: could not write warm cache " << path << std::endl;
+}
+
+// Acquisition time covered, against the wall and CPU time it took; with a
+// virtual clock this is the cost of the pipeline alone
+static void printRunCost(Clock &clock, Clock::time_point start, std::chrono::steady_clock::time_point wall_start,
+                         std::clock_t cpu_start)
+{
+    double covered = std::chrono::duration<double>(clock.now() - start).count();
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    double cpu = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    std::cout << "Covered " << covered << " s of acquisition in " << wall << " s wall, " << cpu << " s CPU" << std::endl;
+}
+
+// Put the sensor to sleep and close the trace; a replay reports how
+// faithfully the driver followed the recording
+static int finish(bmp280_handle_t *handle, bmp280_interface_record_t *rec, const bmp280_interface_replay_t *rep)
+{
+    // The trace is closed first so that it ends with the last sample
+    // whether the run was stopped or killed; a replay then has no
+    // shutdown transactions to answer the deinit with
+    if (rec != nullptr)
+        bmp280_interface_record_close(rec);
+    if (rep != nullptr)
+        std::cout << "Replayed " << rep->records << " transactions, " << rep->divergences << " divergences" << std::endl;
+    else
+        bmp280_deinit(handle);
+    return 0;
+}
+
+int main(int argc, char **argv)
 {
     bmp280_handle_t handle;
+    bmp280_interface_iic_bus_t bus;
+    bmp280_interface_spi_bus_t spi;
+    bmp280_interface_sim_t sim;
+    bmp280_interface_record_t rec;
+    bmp280_interface_replay_t rep;
     uint8_t res;
+    bool stream = false;
+    bool use_sim = false;
+    const char *warm_cache = nullptr;
+    const char *spi_path = nullptr;
+    const char *record_path = nullptr;
+    const char *replay_path = nullptr;
+    bool replay_realtime = false;
+    bool use_worker = false;
+    RealtimeConfig rt;
+    const char *latency_path = nullptr;
+    bool virtual_time = false;
+    double duration_s = 0;
+    size_t sink_depth = 256;
+    const char *sink_policy = nullptr;
+
+    // --stream: free-running NORMAL mode instead of triggered FORCED samples
+    // --warm-cache PATH: reuse calibration and configuration saved by a previous run
+    // --spi PATH: sensor on a spidev device instead of I2C
+    // --sim: in-process simulated sensor, on I2C or behind --spi framing
+    // --record PATH: log every I2C transaction to a trace file
+    // --replay PATH / --replay-realtime PATH: run against a recorded trace,
+    //   as fast as possible on a virtual clock or at the recorded pace
+    // --bus-worker: route I2C through a dedicated bus-owner thread; with one
+    //   sensor it only moves the transfers, coalescing needs several handles
+    //   on the adapter (see bench/check_bus.cpp)
+    // --rt-cpu N / --rt-priority N: real-time acquisition, pinned to core N
+    //   and/or under SCHED_FIFO at priority N, with memory locked
+    // --latency-log PATH: per-sample wake-up latency as CSV, against the
+    //   scheduler deadline or, with --stream, the predicted update
+    // --virtual-time: with --sim, every wait advances a virtual clock
+    //   instead of sleeping
+    // --duration S: stop after S seconds of (virtual) acquisition time
+    // --sink-depth N / --sink-policy drop-oldest|drop-newest|block: queue
+    //   between acquisition and printing, and what to do when it is full
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--stream") == 0)
+            stream = true;
+        else if (std::strcmp(argv[i], "--warm-cache") == 0 && i + 1 < argc)
+            warm_cache = argv[++i];
+        else if (std::strcmp(argv[i], "--spi") == 0 && i + 1 < argc)
+            spi_path = argv[++i];
+        else if (std::strcmp(argv[i], "--sim") == 0)
+            use_sim = true;
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            record_path = argv[++i];
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replay_path = argv[++i];
+        else if (std::strcmp(argv[i], "--replay-realtime") == 0 && i + 1 < argc)
+        {
+            replay_path = argv[++i];
+            replay_realtime = true;
+        }
+        else if (std::strcmp(argv[i], "--bus-worker") == 0)
+            use_worker = true;
+        else if (std::strcmp(argv[i], "--rt-cpu") == 0 && i + 1 < argc)
+            rt.cpu = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--rt-priority") == 0 && i + 1 < argc)
+            rt.priority = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--latency-log") == 0 && i + 1 < argc)
+            latency_path = argv[++i];
+        else if (std::strcmp(argv[i], "--virtual-time") == 0)
+            virtual_time = true;
+        else if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
+            duration_s = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--sink-depth") == 0 && i + 1 < argc)
+            sink_depth = std::strtoul(argv[++i], nullptr, 0);
+        else if (std::strcmp(argv[i], "--sink-policy") == 0 && i + 1 < argc)
+            sink_policy = argv[++i];
+    }
+
+    // No SA_RESTART: a stop request also cuts the scheduler's sleep short
+    struct sigaction action = {};
+    action.sa_handler = onStopSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    // Virtual time only makes sense against a chip that lives on the same clock
+    if (virtual_time && !use_sim)
+    {
+        std::cerr << "--virtual-time needs --sim" << std::endl;
+        return -1;
+    }
+    // A replay that is not paced has no real time to wait for either: every
+    // driver delay, sampler wait and scheduler deadline advances the
+    // virtual clock, so a run costs only the CPU work in it
+    bool virtual_run = virtual_time || (replay_path != nullptr && !replay_realtime);
+    VirtualClock virtual_clock;
+    Clock &clock = virtual_run ? static_cast<Clock &>(virtual_clock) : Clock::system();
+    bindDriverClock(clock);
+
+    // A trace always starts from the cold init so that a replay issues the
+    // same transactions as the recording
+    if (record_path != nullptr || replay_path != nullptr)
+    {
+        warm_cache = nullptr;
+        spi_path = nullptr;
+    }
+
+    // Bus context, pointed at an adapter by the warm cache or by discovery
+    bmp280_interface_iic_bus_init(&bus, 1);
+    if (spi_path != nullptr && bmp280_interface_spi_bus_init_path(&spi, spi_path) != 0)
+    {
+        std::cerr << "Invalid SPI device " << spi_path << std::endl;
+        return -1;
+    }
+    if (use_sim)
+    {
+        bmp280_interface_sim_init(&sim, 0x76);
+        if (virtual_run)
+        {
+            sim.now_us = clockNowUs;
+            sim.sleep_us = clockSleepUs;
+            sim.now_ctx = &clock;
+        }
+        if (spi_path != nullptr)
+            bmp280_interface_spi_set_transfer(&spi, bmp280_interface_sim_spi_transfer, &sim);
+    }
+    const char *bus_path = spi_path != nullptr ? spi.path : replay_path != nullptr ? "replay" : use_sim ? "sim" : bus.path;
+
+    // I2C backend: adapter, simulator or trace replay, optionally recorded
+    void *iic_bus = &bus;
+    decltype(handle.iic_init) iic_init = bmp280_interface_iic_init;
+    decltype(handle.iic_deinit) iic_deinit = bmp280_interface_iic_deinit;
+    decltype(handle.iic_read) iic_read = bmp280_interface_iic_read;
+    decltype(handle.iic_write) iic_write = bmp280_interface_iic_write;
+    if (replay_path != nullptr)
+    {
+        if (bmp280_interface_replay_open(&rep, replay_path, replay_realtime ? 1 : 0) != 0)
+            return -1;
+        iic_bus = &rep;
+        iic_init = bmp280_interface_replay_iic_init;
+        iic_deinit = bmp280_interface_replay_iic_deinit;
+        iic_read = bmp280_interface_replay_iic_read;
+        iic_write = bmp280_interface_replay_iic_write;
+    }
+    else if (use_sim)
+    {
+        iic_bus = &sim;
+        iic_init = bmp280_interface_sim_iic_init;
+        iic_deinit = bmp280_interface_sim_iic_deinit;
+        iic_read = bmp280_interface_sim_iic_read;
+        iic_write = bmp280_interface_sim_iic_write;
+    }
+    if (record_path != nullptr)
+    {
+        if (bmp280_interface_record_open(&rec, record_path, iic_bus, iic_init, iic_deinit, iic_read, iic_write) != 0)
+            return -1;
+        iic_bus = &rec;
+        iic_init = bmp280_interface_record_iic_init;
+        iic_deinit = bmp280_interface_record_iic_deinit;
+        iic_read = bmp280_interface_record_iic_read;
+        iic_write = bmp280_interface_record_iic_write;
+    }
+
+    // Bus-owner thread: every transfer becomes a queued descriptor, and the
+    // adapter path gets batched reads
+    std::unique_ptr<BusWorker> worker;
+    if (use_worker && spi_path == nullptr)
+    {
+        BusBackend backend = {iic_bus, iic_init, iic_deinit, iic_read, iic_write,
+                              iic_bus == &bus ? bmp280_interface_iic_read_batch : nullptr};
+        worker.reset(new BusWorker(backend));
+        iic_bus = worker.get();
+        iic_init = BusWorker::iicInit;
+        iic_deinit = BusWorker::iicDeinit;
+        iic_read = BusWorker::iicRead;
+        iic_write = BusWorker::iicWrite;
+    }
 
     // Initialize handle structure
     DRIVER_BMP280_LINK_INIT(&handle, bmp280_handle_t);
     
     // Link interface functions
-    DRIVER_BMP280_LINK_IIC_INIT(&handle, bmp280_interface_iic_init);
-    DRIVER_BMP280_LINK_IIC_DEINIT(&handle, bmp280_interface_iic_deinit);
-    DRIVER_BMP280_LINK_IIC_READ(&handle, bmp280_interface_iic_read);
-    DRIVER_BMP280_LINK_IIC_WRITE(&handle, bmp280_interface_iic_write);
+    if (spi_path != nullptr)
+        DRIVER_BMP280_LINK_BUS(&handle, &spi);
+    else
+        DRIVER_BMP280_LINK_BUS(&handle, iic_bus);
+    DRIVER_BMP280_LINK_IIC_INIT(&handle, iic_init);
+    DRIVER_BMP280_LINK_IIC_DEINIT(&handle, iic_deinit);
+    DRIVER_BMP280_LINK_IIC_READ(&handle, iic_read);
+    DRIVER_BMP280_LINK_IIC_WRITE(&handle, iic_write);
     DRIVER_BMP280_LINK_SPI_INIT(&handle, bmp280_interface_spi_init);
     DRIVER_BMP280_LINK_SPI_DEINIT(&handle, bmp280_interface_spi_deinit);
     DRIVER_BMP280_LINK_SPI_READ(&handle, bmp280_interface_spi_read);
     DRIVER_BMP280_LINK_SPI_WRITE(&handle, bmp280_interface_spi_write);
-    DRIVER_BMP280_LINK_DELAY_MS(&handle, bmp280_interface_delay_ms);
+    DRIVER_BMP280_LINK_DELAY_MS(&handle, virtual_run ? clockDelayMs : replay_path != nullptr ?
+                                         bmp280_interface_replay_delay_ms : bmp280_interface_delay_ms);
+    DRIVER_BMP280_LINK_DELAY_US(&handle, virtual_run ? clockDelayUs : replay_path != nullptr ?
+                                         bmp280_interface_replay_delay_us : bmp280_interface_delay_us);
     DRIVER_BMP280_LINK_DEBUG_PRINT(&handle, bmp280_interface_debug_print);
+    bmp280_set_interface(&handle, spi_path != nullptr ? BMP280_INTERFACE_SPI : BMP280_INTERFACE_IIC);
 
-    // Try common BMP280 addresses 0x76 and 0x77
-    uint8_t addresses[] = {0x76, 0x77};
-    bool found = false;
-
-    for (auto addr : addresses)
+    // Warm start: one burst read checks the cached state against the chip;
+    // on any mismatch fall back to discovery below
+    bool warm = false;
+    bmp280_warm_state_t warm_state;
+    std::string warm_bus;
+    uint8_t warm_addr;
+    if (warm_cache != nullptr && loadWarmCache(warm_cache, warm_bus, warm_addr, warm_state) &&
+        (spi_path != nullptr || use_sim ? warm_bus == bus_path : bmp280_interface_iic_bus_init_path(&bus, warm_bus.c_str()) == 0))
     {
-        handle.iic_addr = addr;
-        res = bmp280_init(&handle);
+        handle.iic_addr = warm_addr;
+        res = bmp280_init_warm(&handle, &warm_state);
         if (res == 0)
         {
-            std::cout << "BMP280 found at 0x" << std::hex << int(addr) << std::dec << std::endl;
-            
-            // Verify by reading chip ID
-            uint8_t chip_id = 0;
-            res = bmp280_get_reg(&handle, 0xD0, &chip_id);
-            std::cout << "Chip ID: 0x" << std::hex << int(chip_id) << std::dec << std::endl;
-            if (chip_id != 0x58)
-            {
-                std::cerr << "Warning: Expected chip ID 0x58, got 0x" << std::hex << int(chip_id) << std::dec << std::endl;
-            }
-            
-            found = true;
-            break;
+            std::cout << "BMP280 warm start on " << bus_path << " at 0x" << std::hex << int(warm_addr) << std::dec << std::endl;
+            warm = true;
+        }
+        else
+        {
+            std::cout << "Warm cache is stale, probing" << std::endl;
         }
     }
 
-    if (!found)
+    if (!warm && (spi_path != nullptr || use_sim || replay_path != nullptr))
     {
-        std::cerr << "Failed to detect BMP280 at 0x76 or 0x77" << std::endl;
-        bmp280_interface_iic_deinit();
-        return -1;
+        // One device per chip select, simulator or trace, nothing to discover
+        handle.iic_addr = use_sim ? sim.addr : 0;
+        if (replay_path != nullptr)
+            bmp280_interface_replay_peek_addr(&rep, &handle.iic_addr);
+        res = bmp280_init(&handle);
+        if (res != 0)
+        {
+            std::cerr << "Failed to initialize BMP280 on " << bus_path << "! Error code: " << int(res) << std::endl;
+            return -1;
+        }
+        std::cout << "BMP280 found on " << bus_path << std::endl;
+    }
+    else if (!warm)
+    {
+        // Chip-ID probe of 0x76/0x77 on every adapter; only the confirmed
+        // sensor gets the full reset and calibration read
+        std::vector<BMP280Device> devices = discoverBMP280();
+        const BMP280Device *sensor = nullptr;
+        for (const BMP280Device &dev : devices)
+        {
+            std::cout << dev.bus << " 0x" << std::hex << int(dev.addr) << ": chip ID 0x" << int(dev.chip_id)
+                      << " " << chipTypeName(dev.type) << ", calibration " << dev.fingerprint << std::dec << std::endl;
+            if (sensor == nullptr && dev.type == BMP280ChipType::BMP280)
+                sensor = &dev;
+        }
+
+        if (sensor == nullptr)
+        {
+            std::cerr << "Failed to detect BMP280 at 0x76 or 0x77" << std::endl;
+            return -1;
+        }
+
+        bmp280_interface_iic_bus_init_path(&bus, sensor->bus.c_str());
+        handle.iic_addr = sensor->addr;
+        res = bmp280_init(&handle);
+        if (res != 0)
+        {
+            std::cerr << "Failed to initialize BMP280! Error code: " << int(res) << std::endl;
+            return -1;
+        }
+        std::cout << "BMP280 found on " << bus.path << " at 0x" << std::hex << int(sensor->addr) << std::dec << std::endl;
     }
 
-    // Configure sensor oversampling
-    res = bmp280_set_temperatue_oversampling(&handle, BMP280_OVERSAMPLING_x4);
+    // Configure sensor oversampling; a warm start already has it applied
+    res = warm ? 0 : bmp280_set_temperatue_oversampling(&handle, BMP280_OVERSAMPLING_x4);
     if (res != 0)
     {
         std::cerr << "Failed to set temperature oversampling! Error code: " << int(res) << std::endl;
-        bmp280_interface_iic_deinit();
+        bmp280_deinit(&handle);
         return -1;
     }
 
-    res = bmp280_set_pressure_oversampling(&handle, BMP280_OVERSAMPLING_x4);
+    res = warm ? 0 : bmp280_set_pressure_oversampling(&handle, BMP280_OVERSAMPLING_x4);
     if (res != 0)
     {
         std::cerr << "Failed to set pressure oversampling! Error code: " << int(res) << std::endl;
-        bmp280_interface_iic_deinit();
+        bmp280_deinit(&handle);
         return -1;
     }
 
-    // Set sensor to FORCED mode - explicitly trigger each measurement
-    res = bmp280_set_mode(&handle, BMP280_MODE_FORCED);
+    // NORMAL mode streams with a 500 ms standby, FORCED mode triggers every
+    // sample. Both are set up, and the warm cache written, before real-time
+    // mode so that the acquisition thread does no file I/O once it is in it
+    BMP280StreamReader reader(&handle, clock);
+    BMP280ForcedSampler sampler(&handle, clock);
+    res = stream ? reader.start(BMP280_STANDBY_TIME_500_MS) : sampler.start();
     if (res != 0)
     {
-        std::cerr << "Failed to set BMP280 mode! Error code: " << int(res) << std::endl;
-        bmp280_interface_iic_deinit();
+        std::cerr << "Failed to start BMP280 " << (stream ? "streaming" : "sampling") << "! Error code: " << int(res)
+                  << std::endl;
+        bmp280_deinit(&handle);
         return -1;
     }
+    if (stream)
+        std::cout << "Streaming every " << reader.periodUs() << " us" << std::endl;
+    if (!warm)
+        saveWarmState(&handle, bus_path, warm_cache);
 
-    // Main loop: read temperature and pressure every 500ms
-    while (true)
-    {
-        uint8_t status = 0;
-        uint32_t temp_raw = 0, pres_raw = 0;
-        float temp_c = 0.0f, pres_hpa = 0.0f;
+    // Acquisition runs until a signal, the end or the first divergence of a
+    // replay, or --duration; a diverged replay never consumes another record
+    Clock::time_point run_start = clock.now();
+    Clock::time_point stop_at = run_start + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(duration_s));
+    std::chrono::steady_clock::time_point wall_start = std::chrono::steady_clock::now();
+    std::clock_t cpu_start = std::clock();
+    auto running = [&]() {
+        return !gs_stop && (replay_path == nullptr || (!bmp280_interface_replay_done(&rep) && rep.divergences == 0)) &&
+               (duration_s <= 0 || clock.now() < stop_at);
+    };
 
-        // Trigger a measurement in FORCED mode
-        res = bmp280_set_mode(&handle, BMP280_MODE_FORCED);
-        if (res != 0)
+    // A live sensor must never wait for the printer; a replay or virtual run
+    // has no real-time pace to protect and keeps every reading instead
+    OverflowPolicy overflow = replay_path != nullptr || virtual_run ? OverflowPolicy::Block : OverflowPolicy::DropOldest;
+    if (sink_policy != nullptr && std::strcmp(sink_policy, "drop-oldest") == 0)
+        overflow = OverflowPolicy::DropOldest;
+    else if (sink_policy != nullptr && std::strcmp(sink_policy, "drop-newest") == 0)
+        overflow = OverflowPolicy::DropNewest;
+    else if (sink_policy != nullptr && std::strcmp(sink_policy, "block") == 0)
+        overflow = OverflowPolicy::Block;
+    else if (sink_policy != nullptr)
+        std::cerr << "Warning: unknown sink policy " << sink_policy << std::endl;
+
+    // Started before real-time mode so that it does not inherit the
+    // acquisition thread's core and priority
+    ReadingSink sink(sink_depth, overflow);
+
+    // Real-time mode for the acquisition loop; setup is done, so everything
+    // it allocated gets locked along with the stack it is about to use. The
+    // latency log's writer thread is started first, like the sink; without
+    // --latency-log it still reports overruns and failed samples, so the
+    // loops never print
+    LatencyLog latency_log;
+    if (!latency_log.open(latency_path))
+    {
+        std::cerr << "Warning: could not open latency log " << latency_path << std::endl;
+        latency_log.open(nullptr);
+    }
+    if (rt.cpu >= 0 || rt.priority > 0)
+    {
+        std::string error;
+        if (enterRealtime(rt, error))
         {
-            std::cerr << "Failed to trigger measurement! Error code: " << int(res) << std::endl;
-            bmp280_interface_delay_ms(500);
-            continue;
+            std::cout << "Real-time mode: memory locked";
+            if (rt.cpu >= 0)
+                std::cout << ", CPU " << rt.cpu;
+            if (rt.priority > 0)
+                std::cout << ", SCHED_FIFO priority " << rt.priority;
+            std::cout << std::endl;
         }
+        else
+            std::cerr << "Warning: real-time mode incomplete: " << error << std::endl;
 
-        // Wait longer for measurement to complete in FORCED mode
-        bmp280_interface_delay_ms(200);
-        bmp280_get_status(&handle, &status);
-        int wait_count = 10;
-        while ((status & BMP280_STATUS_MEASURING) && wait_count > 0)
+        // Every transfer waits on the bus worker, so it gets the same core
+        // and priority; at SCHED_OTHER anything could preempt it while the
+        // acquisition thread is blocked
+        if (worker && !applyRealtime(worker->nativeHandle(), rt, error))
+            std::cerr << "Warning: bus worker not real-time: " << error << std::endl;
+    }
+
+    // NORMAL mode streaming: the sensor free-runs with a 500 ms standby and
+    // every loop wakes once per fresh sample
+    if (stream)
+    {
+        while (running())
         {
-            bmp280_interface_delay_ms(20);
-            bmp280_get_status(&handle, &status);
-            wait_count--;
+            BMP280Reading reading;
+
+            // next() backs off after a failure; a bus that stays down ends
+            // the stream instead of retrying forever
+            res = reader.next(reading);
+            if (res != 0)
+            {
+                latency_log.recordError(res);
+                if (reader.failures() >= kMaxStreamFailures)
+                    break;
+                continue;
+            }
+            latency_log.record(reader.tick());
+
+            sink.push(reading);
         }
+        sink.stop();
+        latency_log.close();
+        if (latency_log.drops() != 0)
+            std::cerr << "Warning: latency log dropped " << latency_log.drops() << " entries" << std::endl;
+        if (reader.failures() >= kMaxStreamFailures)
+            std::cerr << "Gave up after " << reader.failures() << " failed reads" << std::endl;
+        if (virtual_run || duration_s > 0)
+            printRunCost(clock, run_start, wall_start, cpu_start);
+        return finish(&handle, record_path != nullptr ? &rec : nullptr, replay_path != nullptr ? &rep : nullptr);
+    }
 
-        if (wait_count == 0)
-        {
-            std::cerr << "Timeout waiting for measurement to complete (status: " << int(status) << ")" << std::endl;
+    // FORCED mode: read temperature and pressure every 500 ms on absolute
+    // deadlines. Each tick wakes one conversion time early, triggers, and
+    // collects at the deadline. A real-time replay is paced by the trace
+    // instead and runs back to back, where sample N+1 converts while
+    // sample N goes to the sink
+    PeriodicScheduler scheduler(replay_realtime ? std::chrono::nanoseconds(0) : std::chrono::milliseconds(500), clock);
+    bool back_to_back = scheduler.period().count() == 0;
+    if (!back_to_back)
+    {
+        // Release each tick one conversion time early; the conversion then
+        // finishes on the grid point and the reading is never a period old
+        scheduler.setLead(std::chrono::microseconds(sampler.measureTimeUs()));
+        scheduler.start();
+    }
+    while (running())
+    {
+        BMP280Reading reading;
+        SchedulerTick tick;
+
+        if (!scheduler.wait(tick))
             continue;
-        }
+        latency_log.record(tick);
 
-        res = bmp280_read_temperature_pressure(&handle, &temp_raw, &temp_c, &pres_raw, &pres_hpa);
+        res = back_to_back ? 0 : sampler.trigger();
+        if (res == 0)
+            res = sampler.collect(reading);
         if (res != 0)
         {
-            std::cerr << "Failed to read BMP280! Error code: " << int(res) << std::endl;
-            bmp280_interface_delay_ms(500);
+            latency_log.recordError(res);
             continue;
         }
 
-        std::cout << "Temp (raw): " << temp_raw << " => " << temp_c << " °C, "
-                  << "Press (raw): " << pres_raw << " => " << pres_hpa << " hPa" << std::endl;
-
-        bmp280_interface_delay_ms(500);
+        // Back to back, sample N+1 converts while sample N goes to the sink.
+        // Not past the end of a replay, which has no record for the trigger;
+        // a failed trigger just leaves the next collect() to start over
+        if (back_to_back && running())
+            (void)sampler.trigger();
+        sink.push(reading);
     }
+    sink.stop();
+    latency_log.close();
+    if (latency_log.drops() != 0)
+        std::cerr << "Warning: latency log dropped " << latency_log.drops() << " entries" << std::endl;
+    if (replay_path == nullptr)
+        scheduler.report(std::cout);
+    if (virtual_run || duration_s > 0)
+        printRunCost(clock, run_start, wall_start, cpu_start);
 
-    bmp280_deinit(&handle);
-    bmp280_interface_iic_deinit();
-    return 0;
+    return finish(&handle, record_path != nullptr ? &rec : nullptr, replay_path != nullptr ? &rep : nullptr);
 }
\ No newline at end of file
@@ -87,6 +87,23 @@
 #define BMP280_REG_RESET               0xE0        /**< soft reset register */
 #define BMP280_REG_ID                  0xD0        /**< chip id register */
 
+/**
+ * @brief shadow register flag definition
+ */
+#define BMP280_SHADOW_CTRL_MEAS        (1 << 0)    /**< ctrl meas shadow is valid */
+#define BMP280_SHADOW_CONFIG           (1 << 1)    /**< config shadow is valid */
+#define BMP280_SHADOW_FORCED           (1 << 2)    /**< a forced conversion was triggered and may still be running */
+
+/**
+ * @brief oversampling factor table, indexed by the osrs register field
+ */
+static const uint8_t gs_oversampling_factor[8] = {0, 1, 2, 4, 8, 16, 16, 16};
+
+/**
+ * @brief standby time table in microseconds, indexed by the t_sb register field
+ */
+static const uint32_t gs_standby_time_us[8] = {500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000};
+
 /**
  * @brief      read multiple bytes
  * @param[in]  *handle pointer to a bmp280 handle structure
@@ -102,8 +119,11 @@ static uint8_t a_bmp280_iic_spi_read(bmp280_handle_t *handle, uint8_t reg, uint8
 {
     if (handle->iic_spi == BMP280_INTERFACE_IIC)                           /* iic interface */
     {
-        if (handle->iic_read(handle->iic_addr, reg, buf, len) != 0)        /* iic read */
+        if (handle->iic_read(handle->bus, handle->iic_addr,
+                             reg, buf, len) != 0)                          /* iic read */
         {
+            handle->shadow_valid = 0;                                      /* drop the shadow registers */
+
             return 1;                                                      /* return error */
         }
 
@@ -112,8 +132,10 @@ static uint8_t a_bmp280_iic_spi_read(bmp280_handle_t *handle, uint8_t reg, uint8
     else                                                                   /* spi interface */
     {
         reg |= 1 << 7;                                                     /* set read mode */
-        if (handle->spi_read(reg, buf, len) != 0)                          /* spi read */
+        if (handle->spi_read(handle->bus, reg, buf, len) != 0)             /* spi read */
         {
+            handle->shadow_valid = 0;                                      /* drop the shadow registers */
+
             return 1;                                                      /* return error */
         }
 
@@ -136,8 +158,11 @@ static uint8_t a_bmp280_iic_spi_write(bmp280_handle_t *handle, uint8_t reg, uint
 {
     if (handle->iic_spi == BMP280_INTERFACE_IIC)                           /* iic interface */
     {
-        if (handle->iic_write(handle->iic_addr, reg, buf, len) != 0)       /* iic write */
+        if (handle->iic_write(handle->bus, handle->iic_addr,
+                              reg, buf, len) != 0)                         /* iic write */
         {
+            handle->shadow_valid = 0;                                      /* drop the shadow registers */
+
             return 1;                                                      /* return error */
         }
 
@@ -146,8 +171,10 @@ static uint8_t a_bmp280_iic_spi_write(bmp280_handle_t *handle, uint8_t reg, uint
     else                                                                   /* spi interface */
     {
         reg &= ~(1 << 7);                                                  /* write mode */
-        if (handle->spi_write(reg, buf, len) != 0)                         /* spi write */
+        if (handle->spi_write(handle->bus, reg, buf, len) != 0)            /* spi write */
         {
+            handle->shadow_valid = 0;                                      /* drop the shadow registers */
+
             return 1;                                                      /* return error */
         }
 
@@ -156,129 +183,302 @@ static uint8_t a_bmp280_iic_spi_write(bmp280_handle_t *handle, uint8_t reg, uint
 }
 
 /**
- * @brief     get nvm calibration
+ * @brief     update the ctrl meas shadow from a value read from the chip
  * @param[in] *handle pointer to a bmp280 handle structure
- * @return    status code
- *            - 0 success
- *            - 1 get calibration data failed
- * @note      none
+ * @param[in] live register value read from the chip
+ * @note      forced mode is one-shot, so the shadow keeps ctrl meas in sleep mode
+ *            and BMP280_SHADOW_FORCED tracks whether the conversion is still running
  */
-static uint8_t a_bmp280_get_nvm_calibration(bmp280_handle_t *handle)
+static void a_bmp280_ctrl_meas_update(bmp280_handle_t *handle, uint8_t live)
 {
-    uint8_t buf[2];
-
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_T1_L, (uint8_t *)buf, 2) != 0)        /* read t1 */
+    handle->ctrl_meas = live;                                                    /* update shadow */
+    if ((live & 0x03) == 0x01)                                                   /* forced mode in progress */
     {
-        handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
-
-        return 1;                                                                              /* return error */
+        handle->ctrl_meas &= ~(3 << 0);                                          /* keep sleep mode */
+        handle->shadow_valid |= BMP280_SHADOW_FORCED;                            /* flag forced */
     }
-    handle->t1 = (uint16_t)buf[1] << 8 | buf[0];                                               /* set t1 */
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_T2_L, (uint8_t *)buf, 2) != 0)        /* read t2 */
+    else
     {
-        handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
-
-        return 1;                                                                              /* return error */
+        handle->shadow_valid &= ~BMP280_SHADOW_FORCED;                           /* clear forced */
     }
-    handle->t2 = (int16_t)((uint16_t)buf[1] << 8 | buf[0]);                                    /* set t2 */
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_T3_L, (uint8_t *)buf, 2) != 0)        /* read t3 */
-    {
-        handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
+    handle->shadow_valid |= BMP280_SHADOW_CTRL_MEAS;                             /* flag valid */
+}
 
-        return 1;                                                                              /* return error */
-    }
-    handle->t3 = (int16_t)((uint16_t)buf[1] << 8 | buf[0]);                                    /* set t3 */
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_P1_L, (uint8_t *)buf, 2) != 0)        /* read p1 */
+/**
+ * @brief      read ctrl meas from the chip and refresh its shadow
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *live pointer to the register value read from the chip
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+static uint8_t a_bmp280_ctrl_meas_refresh(bmp280_handle_t *handle, uint8_t *live)
+{
+    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, live, 1) != 0)       /* read ctrl meas */
     {
-        handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
-
-        return 1;                                                                              /* return error */
+        return 1;                                                                /* return error */
     }
-    handle->p1 = (uint16_t)buf[1] << 8 | buf[0];                                               /* set p1 */
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_P2_L, (uint8_t *)buf, 2) != 0)        /* read p2 */
+    a_bmp280_ctrl_meas_update(handle, *live);                                    /* update shadow */
+
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief      read status, ctrl meas, config and the data registers in one burst
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *buf pointer to a 10 bytes buffer holding 0xF3 - 0xFC
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       the shadow registers are refreshed from the snapshot
+ */
+static uint8_t a_bmp280_read_window(bmp280_handle_t *handle, uint8_t *buf)
+{
+    if (a_bmp280_iic_spi_read(handle, BMP280_REG_STATUS, buf, 10) != 0)          /* read 0xF3 - 0xFC */
     {
-        handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
+        return 1;                                                                /* return error */
+    }
+    a_bmp280_ctrl_meas_update(handle, buf[1]);                                   /* update ctrl meas shadow */
+    handle->config = buf[2];                                                     /* update config shadow */
+    handle->shadow_valid |= BMP280_SHADOW_CONFIG;                                /* flag valid */
 
-        return 1;                                                                              /* return error */
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     delay in microseconds
+ * @param[in] *handle pointer to a bmp280 handle structure
+ * @param[in] us delay time in microseconds
+ * @note      falls back to delay_ms rounded up when delay_us is not linked
+ */
+static void a_bmp280_delay_us(bmp280_handle_t *handle, uint32_t us)
+{
+    if (handle->delay_us != NULL)                                                /* delay_us is linked */
+    {
+        handle->delay_us(us);                                                    /* delay us */
     }
-    handle->p2 = (int16_t)((uint16_t)buf[1] << 8 | buf[0]);                                    /* set p2 */
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_P3_L, (uint8_t *)buf, 2) != 0)        /* read p3 */
+    else
     {
-        handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
+        handle->delay_ms((us + 999) / 1000);                                     /* delay ms */
+    }
+}
 
-        return 1;                                                                              /* return error */
+/**
+ * @brief     maximum measurement time for a ctrl meas value
+ * @param[in] ctrl_meas ctrl meas register value
+ * @return    measurement time in microseconds
+ * @note      t_measure,max = 1.25 ms + 2.3 ms * osrs_t + (2.3 ms * osrs_p + 0.575 ms)
+ */
+static uint32_t a_bmp280_measure_time_us(uint8_t ctrl_meas)
+{
+    uint32_t osrs_t;
+    uint32_t osrs_p;
+    uint32_t us;
+
+    osrs_t = gs_oversampling_factor[(ctrl_meas >> 5) & 0x07];                    /* temperature oversampling */
+    osrs_p = gs_oversampling_factor[(ctrl_meas >> 2) & 0x07];                    /* pressure oversampling */
+    us = 1250 + 2300 * osrs_t;                                                   /* startup and temperature */
+    if (osrs_p != 0)                                                             /* pressure enabled */
+    {
+        us += 2300 * osrs_p + 575;                                               /* pressure */
     }
-    handle->p3 = (int16_t)((uint16_t)buf[1] << 8 | buf[0]);                                    /* set p3 */
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_P4_L, (uint8_t *)buf, 2) != 0)        /* read p4 */
+
+    return us;                                                                   /* return time */
+}
+
+/**
+ * @brief      wait for a forced conversion and read its data
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *buf pointer to a 6 bytes data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 5 read timeout
+ * @note       sleeps the datasheet t_measure,max for the configured oversampling, then
+ *             confirms with one burst of status, ctrl meas, config and data, so a
+ *             finished conversion costs a single read; polling is only a fallback
+ */
+static uint8_t a_bmp280_forced_wait(bmp280_handle_t *handle, uint8_t *buf)
+{
+    uint8_t window[10];
+    uint32_t timeout;
+
+    a_bmp280_delay_us(handle, a_bmp280_measure_time_us(handle->ctrl_meas));      /* wait for the conversion */
+    timeout = 10 * 1000;                                                         /* set timeout */
+    while (timeout != 0)                                                         /* check timeout */
     {
-        handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
+        if (a_bmp280_read_window(handle, window) != 0)                           /* read status - data */
+        {
+            handle->debug_print("bmp280: read failed.\n");                       /* read failed */
 
-        return 1;                                                                              /* return error */
+            return 1;                                                            /* return error */
+        }
+        if (((window[1] & 0x03) == 0) &&
+            ((window[0] & BMP280_STATUS_MEASURING) == 0))                        /* if finished */
+        {
+            memcpy(buf, &window[4], 6);                                          /* copy temperature and pressure */
+
+            return 0;                                                            /* success return 0 */
+        }
+        a_bmp280_delay_us(handle, 1000);                                         /* delay 1ms */
+        timeout--;                                                               /* timeout-- */
     }
-    handle->p4 = (int16_t)((uint16_t)buf[1] << 8 | buf[0]);                                    /* set p4 */
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_P5_L, (uint8_t *)buf, 2) != 0)        /* read p5 */
-    {
-        handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
+    handle->debug_print("bmp280: read timeout.\n");                              /* read timeout */
 
-        return 1;                                                                              /* return error */
+    return 5;                                                                    /* return error */
+}
+
+/**
+ * @brief      read a writable register through the host-side shadow
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[in]  reg BMP280_REG_CTRL_MEAS or BMP280_REG_CONFIG
+ * @param[out] *value pointer to a register value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       the bus is only touched when the shadow is not valid
+ */
+static uint8_t a_bmp280_shadow_read(bmp280_handle_t *handle, uint8_t reg, uint8_t *value)
+{
+    uint8_t live;
+
+    if (reg == BMP280_REG_CTRL_MEAS)                                             /* ctrl meas */
+    {
+        if ((handle->shadow_valid & BMP280_SHADOW_CTRL_MEAS) == 0)               /* shadow is not valid */
+        {
+            if (a_bmp280_ctrl_meas_refresh(handle, &live) != 0)                  /* refresh ctrl meas */
+            {
+                return 1;                                                        /* return error */
+            }
+        }
+        *value = handle->ctrl_meas;                                              /* get value */
     }
-    handle->p5 = (int16_t)((uint16_t)buf[1] << 8 | buf[0]);                                    /* set p5 */
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_P6_L, (uint8_t *)buf, 2) != 0)        /* read p6 */
+    else                                                                         /* config */
     {
-        handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
+        if ((handle->shadow_valid & BMP280_SHADOW_CONFIG) == 0)                  /* shadow is not valid */
+        {
+            if (a_bmp280_iic_spi_read(handle, BMP280_REG_CONFIG,
+                                      &handle->config, 1) != 0)                  /* read config */
+            {
+                return 1;                                                        /* return error */
+            }
+            handle->shadow_valid |= BMP280_SHADOW_CONFIG;                        /* flag valid */
+        }
+        *value = handle->config;                                                 /* get value */
+    }
 
-        return 1;                                                                              /* return error */
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     write a writable register and update the host-side shadow
+ * @param[in] *handle pointer to a bmp280 handle structure
+ * @param[in] reg BMP280_REG_CTRL_MEAS or BMP280_REG_CONFIG
+ * @param[in] value written value
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+static uint8_t a_bmp280_shadow_write(bmp280_handle_t *handle, uint8_t reg, uint8_t value)
+{
+    if (a_bmp280_iic_spi_write(handle, reg, &value, 1) != 0)               /* write register */
+    {
+        return 1;                                                          /* return error */
     }
-    handle->p6 = (int16_t)((uint16_t)buf[1] << 8 | buf[0]);                                    /* set p6 */
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_P7_L, (uint8_t *)buf, 2) != 0)        /* read p7 */
+    if (reg == BMP280_REG_CTRL_MEAS)                                       /* ctrl meas */
     {
-        handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
-
-        return 1;                                                                              /* return error */
+        if ((value & 0x03) == 0x01)                                        /* forced mode */
+        {
+            value &= ~(3 << 0);                                            /* chip returns to sleep */
+            handle->shadow_valid |= BMP280_SHADOW_FORCED;                  /* flag forced */
+        }
+        else
+        {
+            handle->shadow_valid &= ~BMP280_SHADOW_FORCED;                 /* clear forced */
+        }
+        handle->ctrl_meas = value;                                         /* update shadow */
+        handle->shadow_valid |= BMP280_SHADOW_CTRL_MEAS;                   /* flag valid */
     }
-    handle->p7 = (int16_t)((uint16_t)buf[1] << 8 | buf[0]);                                    /* set p7 */
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_P8_L, (uint8_t *)buf, 2) != 0)        /* read p8 */
+    else                                                                   /* config */
     {
-        handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
-
-        return 1;                                                                              /* return error */
+        handle->config = value;                                            /* update shadow */
+        handle->shadow_valid |= BMP280_SHADOW_CONFIG;                      /* flag valid */
     }
-    handle->p8 = (int16_t)((uint16_t)buf[1] << 8 | buf[0]);                                    /* set p8 */
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_P9_L, (uint8_t *)buf, 2) != 0)        /* read p9 */
+
+    return 0;                                                              /* success return 0 */
+}
+
+/**
+ * @brief      parse the nvm calibration block
+ * @param[in]  *buf pointer to the 24 bytes of 0x88 - 0x9F
+ * @param[out] *calibration pointer to a bmp280 calibration structure
+ * @note       none
+ */
+static void a_bmp280_parse_calibration(const uint8_t *buf, bmp280_calibration_t *calibration)
+{
+    calibration->t1 = (uint16_t)buf[1] << 8 | buf[0];                                          /* set t1 */
+    calibration->t2 = (int16_t)((uint16_t)buf[3] << 8 | buf[2]);                               /* set t2 */
+    calibration->t3 = (int16_t)((uint16_t)buf[5] << 8 | buf[4]);                               /* set t3 */
+    calibration->p1 = (uint16_t)buf[7] << 8 | buf[6];                                          /* set p1 */
+    calibration->p2 = (int16_t)((uint16_t)buf[9] << 8 | buf[8]);                               /* set p2 */
+    calibration->p3 = (int16_t)((uint16_t)buf[11] << 8 | buf[10]);                             /* set p3 */
+    calibration->p4 = (int16_t)((uint16_t)buf[13] << 8 | buf[12]);                             /* set p4 */
+    calibration->p5 = (int16_t)((uint16_t)buf[15] << 8 | buf[14]);                             /* set p5 */
+    calibration->p6 = (int16_t)((uint16_t)buf[17] << 8 | buf[16]);                             /* set p6 */
+    calibration->p7 = (int16_t)((uint16_t)buf[19] << 8 | buf[18]);                             /* set p7 */
+    calibration->p8 = (int16_t)((uint16_t)buf[21] << 8 | buf[20]);                             /* set p8 */
+    calibration->p9 = (int16_t)((uint16_t)buf[23] << 8 | buf[22]);                             /* set p9 */
+}
+
+/**
+ * @brief     get nvm calibration
+ * @param[in] *handle pointer to a bmp280 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 get calibration data failed
+ * @note      none
+ */
+static uint8_t a_bmp280_get_nvm_calibration(bmp280_handle_t *handle)
+{
+    uint8_t buf[24];
+
+    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_T1_L, (uint8_t *)buf, 24) != 0)       /* read t1 - p9 in one burst */
     {
         handle->debug_print("bmp280: get calibration data failed.\n");                         /* get calibration data failed */
 
         return 1;                                                                              /* return error */
     }
-    handle->p9 = (int16_t)((uint16_t)buf[1] << 8 | buf[0]);                                    /* set p9 */
-    handle->t_fine = 0;                                                                        /* init 0 */
+    a_bmp280_parse_calibration(buf, &handle->calibration);                                     /* set t1 - p9 */
+    handle->coefficients = bmp280_compile_calibration(&handle->calibration);                   /* fold coefficients */
 
     return 0;                                                                                  /* success return 0 */
 }
 
 /**
  * @brief      compensate temperature
- * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[in]  *coeff pointer to a bmp280 coefficients structure
  * @param[in]  raw raw data
+ * @param[out] *t_fine pointer to a fine temperature buffer
  * @param[out] *output pointer to an output buffer
  * @return     status code
  *             - 0 success
  *             - 1 compensate temperature failed
- * @note       none
+ * @note       x = raw / 2^17 - t1 / 2^13, t_fine = x * (8 * t2 + t3 * x)
  */
-static uint8_t a_bmp280_compensate_temperature(bmp280_handle_t *handle, uint32_t raw, float *output)
+static uint8_t a_bmp280_compensate_temperature(const bmp280_coefficients_t *coeff, uint32_t raw,
+                                               int32_t *t_fine, float *output)
 {
     uint8_t res;
-    float var1;
-    float var2;
+    float x;
+    float sum;
     float temperature;
 
-    var1 = (((float)raw) / 16384.0f - ((float)handle->t1) / 1024.0f) * ((float)handle->t2);        /* set var1 */
-    var2 = ((((float)raw) / 131072.0f - ((float)handle->t1) / 8192.0f) *
-           (((float)raw) / 131072.0f - ((float)handle->t1) / 8192.0f)) *
-           ((float)handle->t3);                                                                    /* set var2 */
-    handle->t_fine = (int32_t)(var1 + var2);                                                       /* set t_fine */
-    temperature = (var1 + var2) / 5120.0f;                                                         /* set temperature */
+    x = (float)raw * (1.0f / 131072.0f) + coeff->t_offset;                                         /* set x */
+    sum = x * (coeff->t_lin + coeff->t_quad * x);                                                  /* set sum */
+    (*t_fine) = (int32_t)sum;                                                                      /* set t_fine */
+    temperature = sum * (1.0f / 5120.0f);                                                          /* set temperature */
     res = 0;                                                                                       /* init 0 */
     if (temperature < -40.0f)                                                                      /* check temperature min */
     {
@@ -297,59 +497,147 @@ static uint8_t a_bmp280_compensate_temperature(bmp280_handle_t *handle, uint32_t
 
 /**
  * @brief      compensate pressure
- * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[in]  *coeff pointer to a bmp280 coefficients structure
+ * @param[in]  t_fine fine temperature from the temperature compensation
  * @param[in]  raw raw data
  * @param[out] *output pointer to an output buffer
  * @return     status code
  *             - 0 success
  *             - 1 compensate pressure failed
- * @note       none
+ * @note       v = t_fine / 2 - 64000, p = num(v, raw) / den(v), output = p + q(p),
+ *             with num, den and q quadratics whose coefficients are folded at init
  */
-static uint8_t a_bmp280_compensate_pressure(bmp280_handle_t *handle, uint32_t raw, float *output)
+static uint8_t a_bmp280_compensate_pressure(const bmp280_coefficients_t *coeff, int32_t t_fine,
+                                            uint32_t raw, float *output)
 {
     uint8_t res;
-    float var1;
-    float var2;
+    float v;
+    float num;
+    float den;
     float pressure;
 
-    var1 = ((float)handle->t_fine / 2.0f) - 64000.0f;                             /* set var1 */
-    var2 = var1 * var1 * ((float)handle->p6) / 32768.0f;                          /* set var2 */
-    var2 = var2 + var1 * ((float)handle->p5) * 2.0f;                              /* set var2 */
-    var2 = (var2 / 4.0f) + (((float)handle->p4) * 65536.0f);                      /* set var2 */
-    var1 = (((float)handle->p3) * var1 * var1 / 524288.0f +
-           ((float)handle->p2) * var1) / 524288.0f;                               /* set var1 */
-    var1 = (1.0f + var1 / 32768.0f) * ((float)handle->p1);                        /* set var1 */
-    pressure = 0.0f;                                                              /* init 0 */
-    if (var1 < 0.0f || var1 > 0.0f)                                               /* check not zero */
-    {
-        pressure = 1048576.0f - (float)raw;                                       /* set pressure */
-        pressure = (pressure - (var2 / 4096.0f)) * 6250.0f / var1;                /* set pressure */
-        var1 = ((float)handle->p9) * pressure * pressure / 2147483648.0f;         /* set var1 */
-        var2 = pressure * ((float)handle->p8) / 32768.0f;                         /* set var2 */
-        pressure = pressure + (var1 + var2 + ((float)handle->p7)) / 16.0f;        /* set pressure */
-        res = 0;                                                                  /* init 0 */
-        if (pressure < 30000.0f)                                                  /* check pressure min */
-        {
-            pressure = 30000.0f;                                                  /* set pressure min */
-            res = 1;                                                              /* set failed */
-        }
-        if (pressure > 110000.0f)                                                 /* check pressure max */
-        {
-            pressure = 110000.0f;                                                 /* set pressure max */
-            res = 1;                                                              /* set failed */
-        }
+    v = (float)t_fine * 0.5f - 64000.0f;                                                /* set v */
+    den = coeff->p_den0 + v * (coeff->p_den1 + v * coeff->p_den2);                      /* set denominator */
+    if (den == 0.0f)                                                                    /* check not zero */
+    {
+        (*output) = 0.0f;                                                               /* set pressure output */
 
-        (*output) = pressure;                                                     /* set pressure output */
+        return 1;                                                                       /* return error */
+    }
+    num = (coeff->p_num0 - (float)raw) - v * (coeff->p_num1 + v * coeff->p_num2);       /* set numerator */
+    pressure = num / den;                                                               /* set pressure */
+    pressure = coeff->p_out0 + pressure * (coeff->p_out1 + coeff->p_out2 * pressure);   /* set pressure */
+    res = 0;                                                                            /* init 0 */
+    if (pressure < 30000.0f)                                                            /* check pressure min */
+    {
+        pressure = 30000.0f;                                                            /* set pressure min */
+        res = 1;                                                                        /* set failed */
+    }
+    if (pressure > 110000.0f)                                                           /* check pressure max */
+    {
+        pressure = 110000.0f;                                                           /* set pressure max */
+        res = 1;                                                                        /* set failed */
+    }
+    (*output) = pressure;                                                               /* set pressure output */
+
+    return res;                                                                         /* return result */
+}
 
-        return res;                                                               /* return result */
+/**
+ * @brief      compensate temperature with the 32 bit integer reference formula
+ * @param[in]  *calib pointer to a bmp280 calibration structure
+ * @param[in]  raw raw data
+ * @param[out] *t_fine pointer to a fine temperature buffer
+ * @param[out] *output pointer to an output buffer in 0.01 degC
+ * @return     status code
+ *             - 0 success
+ *             - 1 compensate temperature failed
+ * @note       bit-exact with the Bosch bmp280_compensate_T_int32 reference
+ */
+static uint8_t a_bmp280_compensate_temperature_fixed(const bmp280_calibration_t *calib, uint32_t raw,
+                                                     int32_t *t_fine, int32_t *output)
+{
+    uint8_t res;
+    int32_t adc;
+    int32_t var1;
+    int32_t var2;
+    int32_t temperature;
+
+    adc = (int32_t)raw;                                                                            /* set adc */
+    var1 = ((((adc >> 3) - ((int32_t)calib->t1 * 2))) * ((int32_t)calib->t2)) >> 11;               /* set var1 */
+    var2 = (((((adc >> 4) - ((int32_t)calib->t1)) *
+              ((adc >> 4) - ((int32_t)calib->t1))) >> 12) *
+            ((int32_t)calib->t3)) >> 14;                                                           /* set var2 */
+    (*t_fine) = var1 + var2;                                                                       /* set t_fine */
+    temperature = ((*t_fine) * 5 + 128) >> 8;                                                      /* set temperature */
+    res = 0;                                                                                       /* init 0 */
+    if (temperature < -4000)                                                                       /* check temperature min */
+    {
+        temperature = -4000;                                                                       /* set min */
+        res = 1;                                                                                   /* set failed */
     }
-    else
+    if (temperature > 8500)                                                                        /* check temperature max */
+    {
+        temperature = 8500;                                                                        /* set max */
+        res = 1;                                                                                   /* set failed */
+    }
+    (*output) = temperature;                                                                       /* set output temperature */
+
+    return res;                                                                                    /* return result */
+}
+
+/**
+ * @brief      compensate pressure with the 64 bit integer reference formula
+ * @param[in]  *calib pointer to a bmp280 calibration structure
+ * @param[in]  t_fine fine temperature from the temperature compensation
+ * @param[in]  raw raw data
+ * @param[out] *output pointer to an output buffer in Q24.8 Pa
+ * @return     status code
+ *             - 0 success
+ *             - 1 compensate pressure failed
+ * @note       bit-exact with the Bosch bmp280_compensate_P_int64 reference,
+ *             left shifts of signed values are written as multiplications
+ */
+static uint8_t a_bmp280_compensate_pressure_fixed(const bmp280_calibration_t *calib, int32_t t_fine,
+                                                  uint32_t raw, uint32_t *output)
+{
+    int64_t var1;
+    int64_t var2;
+    int64_t pressure;
+
+    var1 = ((int64_t)t_fine) - 128000;                                            /* set var1 */
+    var2 = var1 * var1 * (int64_t)calib->p6;                                      /* set var2 */
+    var2 = var2 + ((var1 * (int64_t)calib->p5) * ((int64_t)1 << 17));             /* set var2 */
+    var2 = var2 + ((int64_t)calib->p4 * ((int64_t)1 << 35));                      /* set var2 */
+    var1 = ((var1 * var1 * (int64_t)calib->p3) >> 8) +
+           ((var1 * (int64_t)calib->p2) * ((int64_t)1 << 12));                    /* set var1 */
+    var1 = ((((int64_t)1 << 47) + var1) * ((int64_t)calib->p1)) >> 33;            /* set var1 */
+    if (var1 == 0)                                                                /* check not zero */
+    {
+        (*output) = 0;                                                            /* set pressure output */
+
+        return 1;                                                                 /* return error */
+    }
+    pressure = 1048576 - (int64_t)raw;                                            /* set pressure */
+    pressure = (((pressure << 31) - var2) * 3125) / var1;                         /* set pressure */
+    var1 = (((int64_t)calib->p9) * (pressure >> 13) * (pressure >> 13)) >> 25;    /* set var1 */
+    var2 = (((int64_t)calib->p8) * pressure) >> 19;                               /* set var2 */
+    pressure = ((pressure + var1 + var2) >> 8) + ((int64_t)calib->p7 * 16);       /* set pressure */
+    if (pressure < (int64_t)30000 * 256)                                          /* check pressure min */
+    {
+        (*output) = (uint32_t)30000 * 256;                                        /* set pressure min */
+
+        return 1;                                                                 /* return error */
+    }
+    if (pressure > (int64_t)110000 * 256)                                         /* check pressure max */
     {
-        res = 1;                                                                  /* set failed */
-        (*output) = pressure;                                                     /* set pressure output */
+        (*output) = (uint32_t)110000 * 256;                                       /* set pressure max */
 
-        return res;                                                               /* return result */
+        return 1;                                                                 /* return error */
     }
+    (*output) = (uint32_t)pressure;                                               /* set pressure output */
+
+    return 0;                                                                     /* success return 0 */
 }
 
 /**
@@ -437,27 +725,32 @@ uint8_t bmp280_get_interface(bmp280_handle_t *handle, bmp280_interface_t *interf
 }
 
 /**
- * @brief     initialize the chip
+ * @brief     close the bus after a failed initialization
+ * @param[in] *handle pointer to a bmp280 handle structure
+ * @note      none
+ */
+static void a_bmp280_bus_deinit(bmp280_handle_t *handle)
+{
+    if (handle->iic_spi == BMP280_INTERFACE_IIC)                                     /* iic interface */
+    {
+        (void)handle->iic_deinit(handle->bus);                                       /* iic deinit */
+    }
+    else                                                                             /* spi interface */
+    {
+        (void)handle->spi_deinit(handle->bus);                                       /* spi deinit */
+    }
+}
+
+/**
+ * @brief     check the linked functions
  * @param[in] *handle pointer to a bmp280 handle structure
  * @return    status code
  *            - 0 success
- *            - 1 iic or spi initialization failed
- *            - 2 handle is NULL
  *            - 3 linked functions is NULL
- *            - 4 id is error
- *            - 5 get nvm calibration failed
- *            - 6 read calibration failed
  * @note      none
  */
-uint8_t bmp280_init(bmp280_handle_t *handle)
+static uint8_t a_bmp280_check_link(bmp280_handle_t *handle)
 {
-    uint8_t id;
-    uint8_t reg;
-
-    if (handle == NULL)                                                              /* check handle */
-    {
-        return 2;                                                                    /* return error */
-    }
     if (handle->debug_print == NULL)                                                 /* check debug_print */
     {
         return 3;                                                                    /* return error */
@@ -517,9 +810,39 @@ uint8_t bmp280_init(bmp280_handle_t *handle)
         return 3;                                                                    /* return error */
     }
 
+    return 0;                                                                        /* success return 0 */
+}
+
+/**
+ * @brief     initialize the chip
+ * @param[in] *handle pointer to a bmp280 handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic or spi initialization failed
+ *            - 2 handle is NULL
+ *            - 3 linked functions is NULL
+ *            - 4 id is error
+ *            - 5 get nvm calibration failed
+ *            - 6 read calibration failed
+ * @note      none
+ */
+uint8_t bmp280_init(bmp280_handle_t *handle)
+{
+    uint8_t id;
+    uint8_t reg;
+
+    if (handle == NULL)                                                              /* check handle */
+    {
+        return 2;                                                                    /* return error */
+    }
+    if (a_bmp280_check_link(handle) != 0)                                            /* check linked functions */
+    {
+        return 3;                                                                    /* return error */
+    }
+
     if (handle->iic_spi == BMP280_INTERFACE_IIC)                                     /* iic interface */
     {
-        if (handle->iic_init() != 0)                                                 /* iic init */
+        if (handle->iic_init(handle->bus) != 0)                                      /* iic init */
         {
             handle->debug_print("bmp280: iic init failed.\n");                       /* iic init failed */
 
@@ -528,7 +851,7 @@ uint8_t bmp280_init(bmp280_handle_t *handle)
     }
     else                                                                             /* spi interface */
     {
-        if (handle->spi_init() != 0)                                                 /* spi init */
+        if (handle->spi_init(handle->bus) != 0)                                      /* spi init */
         {
             handle->debug_print("bmp280: spi init failed.\n");                       /* spi init failed */
 
@@ -539,14 +862,14 @@ uint8_t bmp280_init(bmp280_handle_t *handle)
     if (a_bmp280_iic_spi_read(handle, BMP280_REG_ID, (uint8_t *)&id, 1) != 0)        /* read chip id */
     {
         handle->debug_print("bmp280: read id failed.\n");                            /* read id failed */
-        (void)handle->iic_deinit();                                                  /* iic deinit */
+        a_bmp280_bus_deinit(handle);                                                 /* bus deinit */
 
         return 4;                                                                    /* return error */
     }
     if (id != 0x58)                                                                  /* check id */
     {
         handle->debug_print("bmp280: id is error.\n");                               /* id is error */
-        (void)handle->iic_deinit();                                                  /* iic deinit */
+        a_bmp280_bus_deinit(handle);                                                 /* bus deinit */
 
         return 4;                                                                    /* return error */
     }
@@ -554,20 +877,165 @@ uint8_t bmp280_init(bmp280_handle_t *handle)
     if (a_bmp280_iic_spi_write(handle, BMP280_REG_RESET, &reg, 1) != 0)              /* reset the chip */
     {
         handle->debug_print("bmp280: reset failed.\n");                              /* reset failed */
-        (void)handle->iic_deinit();                                                  /* iic deinit */
+        a_bmp280_bus_deinit(handle);                                                 /* bus deinit */
+
+        return 5;                                                                    /* return error */
+    }
+    handle->delay_ms(5);                                                             /* delay 5ms */
+    handle->shadow_valid = 0;                                                        /* invalidate the shadow registers */
+    if (a_bmp280_get_nvm_calibration(handle) != 0)                                   /* get nvm calibration */
+    {
+        a_bmp280_bus_deinit(handle);                                                 /* bus deinit */
+
+        return 6;                                                                    /* return error */
+    }
+    handle->inited = 1;                                                              /* flag finish initialization */
+
+    return 0;                                                                        /* success return 0 */
+}
+
+/**
+ * @brief     initialize the chip from a saved warm state
+ * @param[in] *handle pointer to a bmp280 handle structure
+ * @param[in] *state pointer to a bmp280 warm state structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic or spi initialization failed
+ *            - 2 handle or state is NULL
+ *            - 3 linked functions is NULL
+ *            - 4 read or write failed
+ *            - 5 state does not match the chip
+ * @note      no reset, one burst of 0x88 - 0xF5 checks the nvm calibration against the
+ *            saved one, the chip id, that the nvm copy is done and that ctrl meas and config
+ *            still hold the saved configuration, on 5 the caller falls back to bmp280_init;
+ *            the mode is not compared, since bmp280_deinit puts the chip to sleep, and a
+ *            saved normal mode is entered again with one ctrl meas write
+ */
+uint8_t bmp280_init_warm(bmp280_handle_t *handle, const bmp280_warm_state_t *state)
+{
+    uint8_t buf[BMP280_REG_CONFIG - BMP280_REG_NVM_PAR_T1_L + 1];
+    bmp280_calibration_t calibration;
+    uint8_t id;
+    uint8_t status;
+    uint8_t ctrl_meas;
+    uint8_t config;
+
+    if ((handle == NULL) || (state == NULL))                                             /* check handle and state */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (a_bmp280_check_link(handle) != 0)                                                /* check linked functions */
+    {
+        return 3;                                                                        /* return error */
+    }
+
+    if (handle->iic_spi == BMP280_INTERFACE_IIC)                                         /* iic interface */
+    {
+        if (handle->iic_init(handle->bus) != 0)                                          /* iic init */
+        {
+            handle->debug_print("bmp280: iic init failed.\n");                           /* iic init failed */
+
+            return 1;                                                                    /* return error */
+        }
+    }
+    else                                                                                 /* spi interface */
+    {
+        if (handle->spi_init(handle->bus) != 0)                                          /* spi init */
+        {
+            handle->debug_print("bmp280: spi init failed.\n");                           /* spi init failed */
+
+            return 1;                                                                    /* return error */
+        }
+    }
+
+    if (a_bmp280_iic_spi_read(handle, BMP280_REG_NVM_PAR_T1_L, buf, sizeof(buf)) != 0)   /* read 0x88 - 0xF5 */
+    {
+        handle->debug_print("bmp280: read failed.\n");                                   /* read failed */
+        a_bmp280_bus_deinit(handle);                                                     /* bus deinit */
+
+        return 4;                                                                        /* return error */
+    }
+    a_bmp280_parse_calibration(buf, &calibration);                                       /* parse t1 - p9 */
+    id = buf[BMP280_REG_ID - BMP280_REG_NVM_PAR_T1_L];                                   /* chip id */
+    status = buf[BMP280_REG_STATUS - BMP280_REG_NVM_PAR_T1_L];                           /* status */
+    ctrl_meas = buf[BMP280_REG_CTRL_MEAS - BMP280_REG_NVM_PAR_T1_L];                     /* ctrl meas */
+    config = buf[BMP280_REG_CONFIG - BMP280_REG_NVM_PAR_T1_L];                           /* config */
+    if ((id != 0x58) || (id != state->chip_id) ||                                        /* check id */
+        (memcmp(&calibration, &state->calibration, sizeof(calibration)) != 0) ||         /* check calibration */
+        ((status & 0x01) != 0) ||                                                        /* check nvm copy done */
+        ((ctrl_meas & 0xFC) != (state->ctrl_meas & 0xFC)) ||                             /* check oversampling */
+        ((config & 0xFD) != (state->config & 0xFD)))                                     /* check config */
+    {
+        handle->debug_print("bmp280: warm state is stale.\n");                           /* warm state is stale */
+        a_bmp280_bus_deinit(handle);                                                     /* bus deinit */
+
+        return 5;                                                                        /* return error */
+    }
+    if (((state->ctrl_meas & 0x03) == 0x03) && ((ctrl_meas & 0x03) != 0x03))            /* normal mode was stopped */
+    {
+        ctrl_meas = (uint8_t)((ctrl_meas & 0xFC) | 0x03);                                /* set normal mode */
+        if (a_bmp280_iic_spi_write(handle, BMP280_REG_CTRL_MEAS, &ctrl_meas, 1) != 0)    /* write ctrl meas */
+        {
+            handle->debug_print("bmp280: write ctrl meas failed.\n");                    /* write ctrl meas failed */
+            a_bmp280_bus_deinit(handle);                                                 /* bus deinit */
+
+            return 4;                                                                    /* return error */
+        }
+    }
+    handle->calibration = state->calibration;                                            /* set calibration */
+    handle->coefficients = bmp280_compile_calibration(&handle->calibration);             /* fold coefficients */
+    handle->shadow_valid = 0;                                                            /* reset the shadow registers */
+    a_bmp280_ctrl_meas_update(handle, ctrl_meas);                                        /* set ctrl meas shadow */
+    handle->config = config;                                                             /* set config shadow */
+    handle->shadow_valid |= BMP280_SHADOW_CONFIG;                                        /* flag valid */
+    handle->inited = 1;                                                                  /* flag finish initialization */
+
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief      get the warm state of the chip
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *state pointer to a bmp280 warm state structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 get warm state failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       save it after the configuration has been applied
+ */
+uint8_t bmp280_get_warm_state(bmp280_handle_t *handle, bmp280_warm_state_t *state)
+{
+    if (handle == NULL)                                                                  /* check handle */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (handle->inited != 1)                                                             /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+
+    if (a_bmp280_iic_spi_read(handle, BMP280_REG_ID, &state->chip_id, 1) != 0)           /* read chip id */
+    {
+        handle->debug_print("bmp280: read id failed.\n");                                /* read id failed */
+
+        return 1;                                                                        /* return error */
+    }
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &state->ctrl_meas) != 0)      /* read ctrl meas */
+    {
+        handle->debug_print("bmp280: read ctrl meas failed.\n");                         /* read ctrl meas failed */
 
-        return 5;                                                                    /* return error */
+        return 1;                                                                        /* return error */
     }
-    handle->delay_ms(5);                                                             /* delay 5ms */
-    if (a_bmp280_get_nvm_calibration(handle) != 0)                                   /* get nvm calibration */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CONFIG, &state->config) != 0)            /* read config */
     {
-        (void)handle->iic_deinit();                                                  /* iic deinit */
+        handle->debug_print("bmp280: read config failed.\n");                            /* read config failed */
 
-        return 6;                                                                    /* return error */
+        return 1;                                                                        /* return error */
     }
-    handle->inited = 1;                                                              /* flag finish initialization */
+    state->calibration = handle->calibration;                                            /* copy calibration */
 
-    return 0;                                                                        /* success return 0 */
+    return 0;                                                                            /* success return 0 */
 }
 
 /**
@@ -594,7 +1062,7 @@ uint8_t bmp280_deinit(bmp280_handle_t *handle)
         return 3;                                                                   /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)         /* read ctrl meas */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)             /* read ctrl meas */
     {
         handle->debug_print("bmp280: read ctrl meas failed.\n");                    /* read ctrl meas failed */
 
@@ -602,7 +1070,7 @@ uint8_t bmp280_deinit(bmp280_handle_t *handle)
     }
     prev &= ~(3 << 0);                                                              /* clear settings */
     prev |= 0 << 0;                                                                 /* set sleep mode */
-    if (a_bmp280_iic_spi_write(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)        /* write ctrl meas */
+    if (a_bmp280_shadow_write(handle, BMP280_REG_CTRL_MEAS, prev) != 0)             /* write ctrl meas */
     {
         handle->debug_print("bmp280: write ctrl meas failed.\n");                   /* write ctrl meas failed */
 
@@ -610,7 +1078,7 @@ uint8_t bmp280_deinit(bmp280_handle_t *handle)
     }
     if (handle->iic_spi == BMP280_INTERFACE_IIC)                                    /* iic interface */
     {
-        if (handle->iic_deinit() != 0)                                              /* iic deinit */
+        if (handle->iic_deinit(handle->bus) != 0)                                   /* iic deinit */
         {
             handle->debug_print("bmp280: iic deinit failed.\n");                    /* iic deinit failed */
 
@@ -619,7 +1087,7 @@ uint8_t bmp280_deinit(bmp280_handle_t *handle)
     }
     else                                                                            /* spi interface */
     {
-        if (handle->spi_deinit() != 0)                                              /* spi deinit */
+        if (handle->spi_deinit(handle->bus) != 0)                                   /* spi deinit */
         {
             handle->debug_print("bmp280: spi deinit failed.\n");                    /* spi deinit failed */
 
@@ -662,6 +1130,7 @@ uint8_t bmp280_soft_reset(bmp280_handle_t *handle)
         return 1;                                                              /* return error */
     }
     handle->delay_ms(5);                                                       /* delay 5ms */
+    handle->shadow_valid = 0;                                                  /* invalidate the shadow registers */
 
     return 0;                                                                  /* success return 0 */
 }
@@ -698,6 +1167,127 @@ uint8_t bmp280_get_status(bmp280_handle_t *handle, uint8_t *status)
     return 0;                                                                  /* success return 0 */
 }
 
+/**
+ * @brief      get the maximum measurement time of one conversion
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *us pointer to a measurement time buffer in microseconds
+ * @return     status code
+ *             - 0 success
+ *             - 1 get measure time failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       t_measure,max = 1.25 ms + 2.3 ms * osrs_t + (2.3 ms * osrs_p + 0.575 ms) from the datasheet
+ */
+uint8_t bmp280_get_measure_time_us(bmp280_handle_t *handle, uint32_t *us)
+{
+    uint8_t prev;
+
+    if (handle == NULL)                                                        /* check handle */
+    {
+        return 2;                                                              /* return error */
+    }
+    if (handle->inited != 1)                                                   /* check handle initialization */
+    {
+        return 3;                                                              /* return error */
+    }
+
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)        /* read ctrl meas */
+    {
+        handle->debug_print("bmp280: read ctrl meas failed.\n");               /* read ctrl meas failed */
+
+        return 1;                                                              /* return error */
+    }
+    *us = a_bmp280_measure_time_us(prev);                                      /* get measure time */
+
+    return 0;                                                                  /* success return 0 */
+}
+
+/**
+ * @brief      get the normal mode standby time
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *us pointer to a standby time buffer in microseconds
+ * @return     status code
+ *             - 0 success
+ *             - 1 get standby time failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       t_standby of the config register
+ */
+uint8_t bmp280_get_standby_time_us(bmp280_handle_t *handle, uint32_t *us)
+{
+    uint8_t config;
+
+    if (handle == NULL)                                                           /* check handle */
+    {
+        return 2;                                                                 /* return error */
+    }
+    if (handle->inited != 1)                                                      /* check handle initialization */
+    {
+        return 3;                                                                 /* return error */
+    }
+
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CONFIG, &config) != 0)            /* read config */
+    {
+        handle->debug_print("bmp280: read config failed.\n");                     /* read config failed */
+
+        return 1;                                                                 /* return error */
+    }
+    *us = gs_standby_time_us[(config >> 5) & 0x07];                               /* standby time */
+
+    return 0;                                                                     /* success return 0 */
+}
+
+/**
+ * @brief      get the normal mode output data period
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *us pointer to a period buffer in microseconds
+ * @return     status code
+ *             - 0 success
+ *             - 1 get period failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       t_measure,typ + t_standby, t_measure,typ = 1 ms + 2 ms * osrs_t + (2 ms * osrs_p + 0.5 ms)
+ */
+uint8_t bmp280_get_normal_period_us(bmp280_handle_t *handle, uint32_t *us)
+{
+    uint8_t ctrl_meas;
+    uint8_t config;
+    uint32_t osrs_t;
+    uint32_t osrs_p;
+
+    if (handle == NULL)                                                           /* check handle */
+    {
+        return 2;                                                                 /* return error */
+    }
+    if (handle->inited != 1)                                                      /* check handle initialization */
+    {
+        return 3;                                                                 /* return error */
+    }
+
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &ctrl_meas) != 0)      /* read ctrl meas */
+    {
+        handle->debug_print("bmp280: read ctrl meas failed.\n");                  /* read ctrl meas failed */
+
+        return 1;                                                                 /* return error */
+    }
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CONFIG, &config) != 0)            /* read config */
+    {
+        handle->debug_print("bmp280: read config failed.\n");                     /* read config failed */
+
+        return 1;                                                                 /* return error */
+    }
+    osrs_t = gs_oversampling_factor[(ctrl_meas >> 5) & 0x07];                     /* temperature oversampling */
+    osrs_p = gs_oversampling_factor[(ctrl_meas >> 2) & 0x07];                     /* pressure oversampling */
+    *us = 1000 + 2000 * osrs_t;                                                   /* startup and temperature */
+    if (osrs_p != 0)                                                              /* pressure enabled */
+    {
+        *us += 2000 * osrs_p + 500;                                               /* pressure */
+    }
+    *us += gs_standby_time_us[(config >> 5) & 0x07];                              /* standby time */
+
+    return 0;                                                                     /* success return 0 */
+}
+
 /**
  * @brief     set temperatue oversampling
  * @param[in] *handle pointer to a bmp280 handle structure
@@ -722,7 +1312,7 @@ uint8_t bmp280_set_temperatue_oversampling(bmp280_handle_t *handle, bmp280_overs
         return 3;                                                              /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)    /* read ctrl meas */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)        /* read ctrl meas */
     {
         handle->debug_print("bmp280: read ctrl meas failed.\n");               /* read ctrl meas failed */
 
@@ -730,7 +1320,7 @@ uint8_t bmp280_set_temperatue_oversampling(bmp280_handle_t *handle, bmp280_overs
     }
     prev &= ~(7 << 5);                                                         /* clear settings */
     prev |= oversampling << 5;                                                 /* set oversampling */
-    if (a_bmp280_iic_spi_write(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)   /* write ctrl meas */
+    if (a_bmp280_shadow_write(handle, BMP280_REG_CTRL_MEAS, prev) != 0)        /* write ctrl meas */
     {
         handle->debug_print("bmp280: write ctrl meas failed.\n");              /* write ctrl meas failed */
 
@@ -764,7 +1354,7 @@ uint8_t bmp280_get_temperatue_oversampling(bmp280_handle_t *handle, bmp280_overs
         return 3;                                                              /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)    /* read ctrl meas */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)        /* read ctrl meas */
     {
         handle->debug_print("bmp280: read ctrl meas failed.\n");               /* read ctrl meas failed */
 
@@ -799,7 +1389,7 @@ uint8_t bmp280_set_pressure_oversampling(bmp280_handle_t *handle, bmp280_oversam
         return 3;                                                              /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)    /* read ctrl meas */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)        /* read ctrl meas */
     {
         handle->debug_print("bmp280: read ctrl meas failed.\n");               /* read ctrl meas failed */
 
@@ -807,7 +1397,7 @@ uint8_t bmp280_set_pressure_oversampling(bmp280_handle_t *handle, bmp280_oversam
     }
     prev &= ~(7 << 2);                                                         /* clear settings */
     prev |= oversampling << 2;                                                 /* set oversampling */
-    if (a_bmp280_iic_spi_write(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)   /* write ctrl meas */
+    if (a_bmp280_shadow_write(handle, BMP280_REG_CTRL_MEAS, prev) != 0)        /* write ctrl meas */
     {
         handle->debug_print("bmp280: write ctrl meas failed.\n");              /* write ctrl meas failed */
 
@@ -841,7 +1431,7 @@ uint8_t bmp280_get_pressure_oversampling(bmp280_handle_t *handle, bmp280_oversam
         return 3;                                                              /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)    /* read ctrl meas */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)        /* read ctrl meas */
     {
         handle->debug_print("bmp280: read ctrl meas failed.\n");               /* read ctrl meas failed */
 
@@ -876,7 +1466,7 @@ uint8_t bmp280_set_mode(bmp280_handle_t *handle, bmp280_mode_t mode)
         return 3;                                                                   /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)         /* read ctrl meas */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)             /* read ctrl meas */
     {
         handle->debug_print("bmp280: read ctrl meas failed.\n");                    /* read ctrl meas failed */
 
@@ -884,7 +1474,7 @@ uint8_t bmp280_set_mode(bmp280_handle_t *handle, bmp280_mode_t mode)
     }
     prev &= ~(3 << 0);                                                              /* clear settings */
     prev |= mode << 0;                                                              /* set mode */
-    if (a_bmp280_iic_spi_write(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)        /* write ctrl meas */
+    if (a_bmp280_shadow_write(handle, BMP280_REG_CTRL_MEAS, prev) != 0)             /* write ctrl meas */
     {
         handle->debug_print("bmp280: write ctrl meas failed.\n");                   /* write ctrl meas failed */
 
@@ -918,11 +1508,19 @@ uint8_t bmp280_get_mode(bmp280_handle_t *handle, bmp280_mode_t *mode)
         return 3;                                                              /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)    /* read ctrl meas */
+    if (((handle->shadow_valid & BMP280_SHADOW_CTRL_MEAS) == 0) ||
+        ((handle->shadow_valid & BMP280_SHADOW_FORCED) != 0))                  /* forced conversion may be running */
     {
-        handle->debug_print("bmp280: read ctrl meas failed.\n");               /* read ctrl meas failed */
+        if (a_bmp280_ctrl_meas_refresh(handle, &prev) != 0)                    /* read ctrl meas */
+        {
+            handle->debug_print("bmp280: read ctrl meas failed.\n");           /* read ctrl meas failed */
 
-        return 1;                                                              /* return error */
+            return 1;                                                          /* return error */
+        }
+    }
+    else
+    {
+        prev = handle->ctrl_meas;                                              /* get shadow */
     }
     *mode = (bmp280_mode_t)((prev >> 0) & 0x3);                                /* set mode */
 
@@ -953,7 +1551,7 @@ uint8_t bmp280_set_standby_time(bmp280_handle_t *handle, bmp280_standby_time_t s
         return 3;                                                                /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CONFIG, &prev, 1) != 0)         /* read config */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CONFIG, &prev) != 0)             /* read config */
     {
         handle->debug_print("bmp280: read config failed.\n");                    /* read config failed */
 
@@ -961,7 +1559,7 @@ uint8_t bmp280_set_standby_time(bmp280_handle_t *handle, bmp280_standby_time_t s
     }
     prev &= ~(7 << 5);                                                           /* clear settings */
     prev |= standby_time << 5;                                                   /* set standby time */
-    if (a_bmp280_iic_spi_write(handle, BMP280_REG_CONFIG, &prev, 1) != 0)        /* write config */
+    if (a_bmp280_shadow_write(handle, BMP280_REG_CONFIG, prev) != 0)             /* write config */
     {
         handle->debug_print("bmp280: write config failed.\n");                   /* write config failed */
 
@@ -995,7 +1593,7 @@ uint8_t bmp280_get_standby_time(bmp280_handle_t *handle, bmp280_standby_time_t *
         return 3;                                                               /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CONFIG, &prev, 1) != 0)        /* read config */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CONFIG, &prev) != 0)            /* read config */
     {
         handle->debug_print("bmp280: read config failed.\n");                   /* read config failed */
 
@@ -1030,7 +1628,7 @@ uint8_t bmp280_set_filter(bmp280_handle_t *handle, bmp280_filter_t filter)
         return 3;                                                                /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CONFIG, &prev, 1) != 0)         /* read config */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CONFIG, &prev) != 0)             /* read config */
     {
         handle->debug_print("bmp280: read config failed.\n");                    /* read config failed */
 
@@ -1038,7 +1636,7 @@ uint8_t bmp280_set_filter(bmp280_handle_t *handle, bmp280_filter_t filter)
     }
     prev &= ~(7 << 2);                                                           /* clear settings */
     prev |= (filter & 0x07) << 2;                                                /* set filter */
-    if (a_bmp280_iic_spi_write(handle, BMP280_REG_CONFIG, &prev, 1) != 0)        /* write config */
+    if (a_bmp280_shadow_write(handle, BMP280_REG_CONFIG, prev) != 0)             /* write config */
     {
         handle->debug_print("bmp280: write config failed.\n");                   /* write config failed */
 
@@ -1072,7 +1670,7 @@ uint8_t bmp280_get_filter(bmp280_handle_t *handle, bmp280_filter_t *filter)
         return 3;                                                                /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CONFIG, &prev, 1) != 0)         /* read config */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CONFIG, &prev) != 0)             /* read config */
     {
         handle->debug_print("bmp280: read config failed.\n");                    /* read config failed */
 
@@ -1107,7 +1705,7 @@ uint8_t bmp280_set_spi_wire(bmp280_handle_t *handle, bmp280_spi_wire_t spi)
         return 3;                                                                /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CONFIG, &prev, 1) != 0)         /* read config */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CONFIG, &prev) != 0)             /* read config */
     {
         handle->debug_print("bmp280: read config failed.\n");                    /* read config failed */
 
@@ -1115,7 +1713,7 @@ uint8_t bmp280_set_spi_wire(bmp280_handle_t *handle, bmp280_spi_wire_t spi)
     }
     prev &= ~(1 << 0);                                                           /* clear settings */
     prev |= spi << 0;                                                            /* set spi wire */
-    if (a_bmp280_iic_spi_write(handle, BMP280_REG_CONFIG, &prev, 1) != 0)        /* write config */
+    if (a_bmp280_shadow_write(handle, BMP280_REG_CONFIG, prev) != 0)             /* write config */
     {
         handle->debug_print("bmp280: write config failed.\n");                   /* write config failed */
 
@@ -1149,7 +1747,7 @@ uint8_t bmp280_get_spi_wire(bmp280_handle_t *handle, bmp280_spi_wire_t *spi)
         return 3;                                                                /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CONFIG, &prev, 1) != 0)         /* read config */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CONFIG, &prev) != 0)             /* read config */
     {
         handle->debug_print("bmp280: read config failed.\n");                    /* read config failed */
 
@@ -1178,7 +1776,7 @@ uint8_t bmp280_read_pressure(bmp280_handle_t *handle, uint32_t *pressure_raw, fl
 {
     uint8_t res;
     uint8_t prev;
-    uint32_t timeout;
+    int32_t t_fine;
     uint32_t temperature_raw;
     float temperature_c;
     uint8_t buf[6];
@@ -1192,7 +1790,7 @@ uint8_t bmp280_read_pressure(bmp280_handle_t *handle, uint32_t *pressure_raw, fl
         return 3;                                                                              /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)                    /* read ctrl meas */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)                        /* read ctrl meas */
     {
         handle->debug_print("bmp280: read ctrl meas failed.\n");                               /* read ctrl meas failed */
 
@@ -1210,7 +1808,8 @@ uint8_t bmp280_read_pressure(bmp280_handle_t *handle, uint32_t *pressure_raw, fl
         temperature_raw = ((((uint32_t)(buf[3])) << 12) |
                           (((uint32_t)(buf[4])) << 4) |
                           ((uint32_t)buf[5] >> 4));                                            /* set temperature raw */
-        res = a_bmp280_compensate_temperature(handle, temperature_raw, &temperature_c);        /* compensate temperature */
+        res = a_bmp280_compensate_temperature(&handle->coefficients, temperature_raw,
+                                              &t_fine, &temperature_c);                        /* compensate temperature */
         if (res != 0)
         {
             handle->debug_print("bmp280: compensate temperature failed.\n");                   /* compensate temperature failed */
@@ -1220,7 +1819,8 @@ uint8_t bmp280_read_pressure(bmp280_handle_t *handle, uint32_t *pressure_raw, fl
         *pressure_raw = ((((int32_t)(buf[0])) << 12) |
                         (((int32_t)(buf[1])) << 4) |
                         (((int32_t)(buf[2])) >> 4));                                           /* set pressure raw */
-        res = a_bmp280_compensate_pressure(handle, *pressure_raw, pressure_pa);                /* compensate pressure */
+        res = a_bmp280_compensate_pressure(&handle->coefficients, t_fine,
+                                           *pressure_raw, pressure_pa);                        /* compensate pressure */
         if (res != 0)
         {
             handle->debug_print("bmp280: compensate pressure failed.\n");                      /* compensate pressure failed */
@@ -1230,7 +1830,7 @@ uint8_t bmp280_read_pressure(bmp280_handle_t *handle, uint32_t *pressure_raw, fl
     }
     else                                                                                       /* forced mode */
     {
-        if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)                /* read ctrl meas */
+        if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)                    /* read ctrl meas */
         {
             handle->debug_print("bmp280: read ctrl meas failed.\n");                           /* read ctrl meas failed */
 
@@ -1238,45 +1838,22 @@ uint8_t bmp280_read_pressure(bmp280_handle_t *handle, uint32_t *pressure_raw, fl
         }
         prev &= ~(3 << 0);                                                                     /* clear settings */
         prev |= 0x01 << 0;                                                                     /* set forced mode */
-        if (a_bmp280_iic_spi_write(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)               /* write ctrl meas */
+        if (a_bmp280_shadow_write(handle, BMP280_REG_CTRL_MEAS, prev) != 0)                    /* write ctrl meas */
         {
             handle->debug_print("bmp280: write ctrl meas failed.\n");                          /* write ctrl meas failed */
 
             return 1;                                                                          /* return error */
         }
-        timeout = 10 * 1000;                                                                   /* set timeout */
-        while (timeout != 0)                                                                   /* check timeout */
-        {
-            if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)            /* read ctrl meas */
-            {
-                handle->debug_print("bmp280: read ctrl meas failed.\n");                       /* read ctrl meas failed */
-
-                return 1;                                                                      /* return error */
-            }
-            if ((prev & 0x03) == 0)                                                            /* if finished */
-            {
-                break;                                                                         /* break */
-            }
-            handle->delay_ms(1);                                                               /* delay 1ms */
-            timeout--;                                                                         /* timeout-- */
-        }
-        if (timeout == 0)                                                                      /* check timeout */
-        {
-            handle->debug_print("bmp280: read timeout.\n");                                    /* read timeout */
-
-            return 5;                                                                          /* return error */
-        }
-        res = a_bmp280_iic_spi_read(handle, BMP280_REG_PRESS_MSB, buf, 6);                     /* read temperature and pressure */
+        res = a_bmp280_forced_wait(handle, buf);                                               /* wait and read temperature and pressure */
         if (res != 0)
         {
-            handle->debug_print("bmp280: read failed.\n");                                     /* read failed */
-
-            return 1;                                                                          /* return error */
+            return res;                                                                        /* return error */
         }
         temperature_raw = ((((uint32_t)(buf[3])) << 12) |
                           (((uint32_t)(buf[4])) << 4) |
                           ((uint32_t)buf[5] >> 4));                                            /* set temperature raw */
-        res = a_bmp280_compensate_temperature(handle, temperature_raw, &temperature_c);        /* compensate temperature */
+        res = a_bmp280_compensate_temperature(&handle->coefficients, temperature_raw,
+                                              &t_fine, &temperature_c);                        /* compensate temperature */
         if (res != 0)
         {
             handle->debug_print("bmp280: compensate temperature failed.\n");                   /* compensate temperature failed */
@@ -1286,7 +1863,8 @@ uint8_t bmp280_read_pressure(bmp280_handle_t *handle, uint32_t *pressure_raw, fl
         *pressure_raw = ((((int32_t)(buf[0])) << 12) |
                         (((int32_t)(buf[1])) << 4) |
                         (((int32_t)(buf[2])) >> 4));                                           /* set pressure raw */
-        res = a_bmp280_compensate_pressure(handle, *pressure_raw, pressure_pa);                /* compensate pressure */
+        res = a_bmp280_compensate_pressure(&handle->coefficients, t_fine,
+                                           *pressure_raw, pressure_pa);                        /* compensate pressure */
         if (res != 0)
         {
             handle->debug_print("bmp280: compensate pressure failed.\n");                      /* compensate pressure failed */
@@ -1316,7 +1894,7 @@ uint8_t bmp280_read_temperature(bmp280_handle_t *handle, uint32_t *temperature_r
 {
     uint8_t res;
     uint8_t prev;
-    uint32_t timeout;
+    int32_t t_fine;
     uint8_t buf[6];
 
     if (handle == NULL)                                                                        /* check handle */
@@ -1328,7 +1906,7 @@ uint8_t bmp280_read_temperature(bmp280_handle_t *handle, uint32_t *temperature_r
         return 3;                                                                              /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)                    /* read ctrl meas */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)                        /* read ctrl meas */
     {
         handle->debug_print("bmp280: read ctrl meas failed.\n");                               /* read ctrl meas failed */
 
@@ -1346,7 +1924,8 @@ uint8_t bmp280_read_temperature(bmp280_handle_t *handle, uint32_t *temperature_r
         *temperature_raw = ((((uint32_t)(buf[3])) << 12) |
                            (((uint32_t)(buf[4])) << 4) |
                            ((uint32_t)buf[5] >> 4));                                           /* set temperature raw */
-        res = a_bmp280_compensate_temperature(handle, *temperature_raw, temperature_c);        /* compensate temperature */
+        res = a_bmp280_compensate_temperature(&handle->coefficients, *temperature_raw,
+                                              &t_fine, temperature_c);                         /* compensate temperature */
         if (res != 0)
         {
             handle->debug_print("bmp280: compensate temperature failed.\n");                   /* compensate temperature failed */
@@ -1356,7 +1935,7 @@ uint8_t bmp280_read_temperature(bmp280_handle_t *handle, uint32_t *temperature_r
     }
     else                                                                                       /* forced mode */
     {
-        if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)                /* read ctrl meas */
+        if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)                    /* read ctrl meas */
         {
             handle->debug_print("bmp280: read ctrl meas failed.\n");                           /* read ctrl meas failed */
 
@@ -1364,45 +1943,22 @@ uint8_t bmp280_read_temperature(bmp280_handle_t *handle, uint32_t *temperature_r
         }
         prev &= ~(3 << 0);                                                                     /* clear settings */
         prev |= 0x01 << 0;                                                                     /* set forced mode */
-        if (a_bmp280_iic_spi_write(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)               /* write ctrl meas */
+        if (a_bmp280_shadow_write(handle, BMP280_REG_CTRL_MEAS, prev) != 0)                    /* write ctrl meas */
         {
             handle->debug_print("bmp280: write ctrl meas failed.\n");                          /* write ctrl meas failed */
 
             return 1;                                                                          /* return error */
         }
-        timeout = 10 * 1000;                                                                   /* set timeout */
-        while (timeout != 0)                                                                   /* check timeout */
-        {
-            if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)            /* read ctrl meas */
-            {
-                handle->debug_print("bmp280: read ctrl meas failed.\n");                       /* read ctrl meas failed */
-
-                return 1;                                                                      /* return error */
-            }
-            if ((prev & 0x03) == 0)                                                            /* if finished */
-            {
-                break;                                                                         /* break */
-            }
-            handle->delay_ms(1);                                                               /* delay 1ms */
-            timeout--;                                                                         /* timeout-- */
-        }
-        if (timeout == 0)                                                                      /* check timeout */
-        {
-            handle->debug_print("bmp280: read timeout.\n");                                    /* read timeout */
-
-            return 5;                                                                          /* return error */
-        }
-        res = a_bmp280_iic_spi_read(handle, BMP280_REG_PRESS_MSB, buf, 6);                     /* read temperature and pressure */
+        res = a_bmp280_forced_wait(handle, buf);                                               /* wait and read temperature and pressure */
         if (res != 0)
         {
-            handle->debug_print("bmp280: read failed.\n");                                     /* read failed */
-
-            return 1;                                                                          /* return error */
+            return res;                                                                        /* return error */
         }
         *temperature_raw = ((((uint32_t)(buf[3])) << 12) |
                            (((uint32_t)(buf[4])) << 4) |
                            ((uint32_t)buf[5] >> 4));                                           /* set temperature raw */
-        res = a_bmp280_compensate_temperature(handle, *temperature_raw, temperature_c);        /* compensate temperature */
+        res = a_bmp280_compensate_temperature(&handle->coefficients, *temperature_raw,
+                                              &t_fine, temperature_c);                         /* compensate temperature */
         if (res != 0)
         {
             handle->debug_print("bmp280: compensate temperature failed.\n");                   /* compensate temperature failed */
@@ -1435,7 +1991,7 @@ uint8_t bmp280_read_temperature_pressure(bmp280_handle_t *handle, uint32_t *temp
 {
     uint8_t res;
     uint8_t prev;
-    uint32_t timeout;
+    int32_t t_fine;
     uint8_t buf[6];
 
     if (handle == NULL)                                                                        /* check handle */
@@ -1447,7 +2003,7 @@ uint8_t bmp280_read_temperature_pressure(bmp280_handle_t *handle, uint32_t *temp
         return 3;                                                                              /* return error */
     }
 
-    if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)                    /* read ctrl meas */
+    if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)                        /* read ctrl meas */
     {
         handle->debug_print("bmp280: read ctrl meas failed.\n");                               /* read ctrl meas failed */
 
@@ -1465,7 +2021,8 @@ uint8_t bmp280_read_temperature_pressure(bmp280_handle_t *handle, uint32_t *temp
         *temperature_raw = ((((uint32_t)(buf[3])) << 12) |
                            (((uint32_t)(buf[4])) << 4) |
                            ((uint32_t)buf[5] >> 4));                                           /* set temperature raw */
-        res = a_bmp280_compensate_temperature(handle, *temperature_raw, temperature_c);        /* compensate temperature */
+        res = a_bmp280_compensate_temperature(&handle->coefficients, *temperature_raw,
+                                              &t_fine, temperature_c);                         /* compensate temperature */
         if (res != 0)
         {
             handle->debug_print("bmp280: compensate temperature failed.\n");                   /* compensate temperature failed */
@@ -1475,7 +2032,8 @@ uint8_t bmp280_read_temperature_pressure(bmp280_handle_t *handle, uint32_t *temp
         *pressure_raw = ((((int32_t)(buf[0])) << 12) |
                         (((int32_t)(buf[1])) << 4) |
                         (((int32_t)(buf[2])) >> 4));                                           /* set pressure raw */
-        res = a_bmp280_compensate_pressure(handle, *pressure_raw, pressure_pa);                /* compensate pressure */
+        res = a_bmp280_compensate_pressure(&handle->coefficients, t_fine,
+                                           *pressure_raw, pressure_pa);                        /* compensate pressure */
         if (res != 0)
         {
             handle->debug_print("bmp280: compensate pressure failed.\n");                      /* compensate pressure failed */
@@ -1485,7 +2043,7 @@ uint8_t bmp280_read_temperature_pressure(bmp280_handle_t *handle, uint32_t *temp
     }
     else                                                                                       /* forced mode */
     {
-        if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)                /* read ctrl meas */
+        if (a_bmp280_shadow_read(handle, BMP280_REG_CTRL_MEAS, &prev) != 0)                    /* read ctrl meas */
         {
             handle->debug_print("bmp280: read ctrl meas failed.\n");                           /* read ctrl meas failed */
 
@@ -1493,45 +2051,22 @@ uint8_t bmp280_read_temperature_pressure(bmp280_handle_t *handle, uint32_t *temp
         }
         prev &= ~(3 << 0);                                                                     /* clear settings */
         prev |= 0x01 << 0;                                                                     /* set forced mode */
-        if (a_bmp280_iic_spi_write(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)               /* write ctrl meas */
+        if (a_bmp280_shadow_write(handle, BMP280_REG_CTRL_MEAS, prev) != 0)                    /* write ctrl meas */
         {
             handle->debug_print("bmp280: write ctrl meas failed.\n");                          /* write ctrl meas failed */
 
             return 1;                                                                          /* return error */
         }
-        timeout = 10 * 1000;                                                                   /* set timeout */
-        while (timeout != 0)                                                                   /* check timeout */
-        {
-            if (a_bmp280_iic_spi_read(handle, BMP280_REG_CTRL_MEAS, &prev, 1) != 0)            /* read ctrl meas */
-            {
-                handle->debug_print("bmp280: read ctrl meas failed.\n");                       /* read ctrl meas failed */
-
-                return 1;                                                                      /* return error */
-            }
-            if ((prev & 0x03) == 0)                                                            /* if finished */
-            {
-                break;                                                                         /* break */
-            }
-            handle->delay_ms(1);                                                               /* delay 1ms */
-            timeout--;                                                                         /* timeout-- */
-        }
-        if (timeout == 0)                                                                      /* check timeout */
-        {
-            handle->debug_print("bmp280: read timeout.\n");                                    /* read timeout */
-
-            return 5;                                                                          /* return error */
-        }
-        res = a_bmp280_iic_spi_read(handle, BMP280_REG_PRESS_MSB, buf, 6);                     /* read temperature and pressure */
+        res = a_bmp280_forced_wait(handle, buf);                                               /* wait and read temperature and pressure */
         if (res != 0)
         {
-            handle->debug_print("bmp280: read failed.\n");                                     /* read failed */
-
-            return 1;                                                                          /* return error */
+            return res;                                                                        /* return error */
         }
         *temperature_raw = ((((uint32_t)(buf[3])) << 12) |
                            (((uint32_t)(buf[4])) << 4) |
                            ((uint32_t)buf[5] >> 4));                                           /* set temperature raw */
-        res = a_bmp280_compensate_temperature(handle, *temperature_raw, temperature_c);        /* compensate temperature */
+        res = a_bmp280_compensate_temperature(&handle->coefficients, *temperature_raw,
+                                              &t_fine, temperature_c);                         /* compensate temperature */
         if (res != 0)
         {
             handle->debug_print("bmp280: compensate temperature failed.\n");                   /* compensate temperature failed */
@@ -1541,7 +2076,8 @@ uint8_t bmp280_read_temperature_pressure(bmp280_handle_t *handle, uint32_t *temp
         *pressure_raw = ((((int32_t)(buf[0])) << 12) |
                         (((int32_t)(buf[1])) << 4) |
                         (((int32_t)(buf[2])) >> 4));                                           /* set pressure raw */
-        res = a_bmp280_compensate_pressure(handle, *pressure_raw, pressure_pa);                /* compensate pressure */
+        res = a_bmp280_compensate_pressure(&handle->coefficients, t_fine,
+                                           *pressure_raw, pressure_pa);                        /* compensate pressure */
         if (res != 0)
         {
             handle->debug_print("bmp280: compensate pressure failed.\n");                      /* compensate pressure failed */
@@ -1553,6 +2089,273 @@ uint8_t bmp280_read_temperature_pressure(bmp280_handle_t *handle, uint32_t *temp
     return 0;                                                                                  /* success return 0 */
 }
 
+/**
+ * @brief      read status, control and data registers as one snapshot
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *sample pointer to a bmp280 sample structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       0xF3 - 0xFC are fetched in a single burst, so status, mode and raw data are consistent
+ */
+uint8_t bmp280_read_sample(bmp280_handle_t *handle, bmp280_sample_t *sample)
+{
+    uint8_t buf[10];
+
+    if (handle == NULL)                                                               /* check handle */
+    {
+        return 2;                                                                     /* return error */
+    }
+    if (handle->inited != 1)                                                          /* check handle initialization */
+    {
+        return 3;                                                                     /* return error */
+    }
+
+    if (a_bmp280_read_window(handle, buf) != 0)                                       /* read 0xF3 - 0xFC */
+    {
+        handle->debug_print("bmp280: read failed.\n");                                /* read failed */
+
+        return 1;                                                                     /* return error */
+    }
+    sample->status = buf[0];                                                          /* set status */
+    sample->ctrl_meas = buf[1];                                                       /* set ctrl meas */
+    sample->config = buf[2];                                                          /* set config */
+    sample->measuring = (buf[0] & BMP280_STATUS_MEASURING) ? 1 : 0;                   /* set measuring */
+    sample->im_update = (buf[0] & BMP280_STATUS_IM_UPDATE) ? 1 : 0;                   /* set im update */
+    sample->mode = (bmp280_mode_t)(buf[1] & 0x03);                                    /* set mode */
+    sample->pressure_raw = ((((uint32_t)(buf[4])) << 12) |
+                           (((uint32_t)(buf[5])) << 4) |
+                           ((uint32_t)buf[6] >> 4));                                  /* set pressure raw */
+    sample->temperature_raw = ((((uint32_t)(buf[7])) << 12) |
+                              (((uint32_t)(buf[8])) << 4) |
+                              ((uint32_t)buf[9] >> 4));                               /* set temperature raw */
+
+    return 0;                                                                         /* success return 0 */
+}
+
+/**
+ * @brief      compensate the raw data of a sample
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[in]  *sample pointer to a bmp280 sample structure
+ * @param[out] *temperature_c pointer to a converted temperature buffer
+ * @param[out] *pressure_pa pointer to a converted pressure buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 compensate failed
+ * @note       no bus access, so a sample can be compensated while the next conversion runs
+ */
+uint8_t bmp280_compensate_sample(bmp280_handle_t *handle, const bmp280_sample_t *sample,
+                                 float *temperature_c, float *pressure_pa)
+{
+    bmp280_compensation_t result;
+
+    if (handle == NULL)                                                                              /* check handle */
+    {
+        return 2;                                                                                    /* return error */
+    }
+    if (handle->inited != 1)                                                                         /* check handle initialization */
+    {
+        return 3;                                                                                    /* return error */
+    }
+
+    result = bmp280_compensate_compiled(&handle->coefficients, sample->temperature_raw,
+                                        sample->pressure_raw);                                       /* compensate */
+    (*temperature_c) = result.temperature_c;                                                         /* set temperature */
+    (*pressure_pa) = result.pressure_pa;                                                             /* set pressure */
+    if ((result.status & BMP280_COMPENSATE_TEMPERATURE_RANGE) != 0)                                  /* check temperature */
+    {
+        handle->debug_print("bmp280: compensate temperature failed.\n");                             /* compensate temperature failed */
+
+        return 4;                                                                                    /* return error */
+    }
+    if ((result.status & BMP280_COMPENSATE_PRESSURE_RANGE) != 0)                                     /* check pressure */
+    {
+        handle->debug_print("bmp280: compensate pressure failed.\n");                                /* compensate pressure failed */
+
+        return 4;                                                                                    /* return error */
+    }
+
+    return 0;                                                                                        /* success return 0 */
+}
+
+/**
+ * @brief      compensate the raw data of a sample with integer arithmetic
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[in]  *sample pointer to a bmp280 sample structure
+ * @param[out] *temperature_centi_c pointer to a converted temperature buffer in 0.01 degC
+ * @param[out] *pressure_q24_8 pointer to a converted pressure buffer in Q24.8 Pa
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 compensate failed
+ * @note       no floating point, results are bit-exact across builds
+ */
+uint8_t bmp280_compensate_sample_fixed(bmp280_handle_t *handle, const bmp280_sample_t *sample,
+                                       int32_t *temperature_centi_c, uint32_t *pressure_q24_8)
+{
+    bmp280_compensation_fixed_t result;
+
+    if (handle == NULL)                                                                                    /* check handle */
+    {
+        return 2;                                                                                          /* return error */
+    }
+    if (handle->inited != 1)                                                                               /* check handle initialization */
+    {
+        return 3;                                                                                          /* return error */
+    }
+
+    result = bmp280_compensate_fixed(&handle->calibration, sample->temperature_raw, sample->pressure_raw); /* compensate */
+    (*temperature_centi_c) = result.temperature_centi_c;                                                   /* set temperature */
+    (*pressure_q24_8) = result.pressure_q24_8;                                                             /* set pressure */
+    if ((result.status & BMP280_COMPENSATE_TEMPERATURE_RANGE) != 0)                                        /* check temperature */
+    {
+        handle->debug_print("bmp280: compensate temperature failed.\n");                                   /* compensate temperature failed */
+
+        return 4;                                                                                          /* return error */
+    }
+    if ((result.status & BMP280_COMPENSATE_PRESSURE_RANGE) != 0)                                           /* check pressure */
+    {
+        handle->debug_print("bmp280: compensate pressure failed.\n");                                      /* compensate pressure failed */
+
+        return 4;                                                                                          /* return error */
+    }
+
+    return 0;                                                                                              /* success return 0 */
+}
+
+/**
+ * @brief      get the calibration data
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *calibration pointer to a bmp280 calibration structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       the copy can be compensated against without the handle
+ */
+uint8_t bmp280_get_calibration(bmp280_handle_t *handle, bmp280_calibration_t *calibration)
+{
+    if (handle == NULL)                                       /* check handle */
+    {
+        return 2;                                             /* return error */
+    }
+    if (handle->inited != 1)                                  /* check handle initialization */
+    {
+        return 3;                                             /* return error */
+    }
+
+    (*calibration) = handle->calibration;                     /* copy calibration */
+
+    return 0;                                                 /* success return 0 */
+}
+
+/**
+ * @brief     fold a calibration into compensation coefficients
+ * @param[in] *calibration pointer to a bmp280 calibration structure
+ * @return    compiled coefficients
+ * @note      folded in double and rounded once to float
+ */
+bmp280_coefficients_t bmp280_compile_calibration(const bmp280_calibration_t *calibration)
+{
+    bmp280_coefficients_t coeff;
+    double p1;
+
+    p1 = (double)calibration->p1;                                                        /* set p1 */
+    coeff.t_offset = (float)(-(double)calibration->t1 / 8192.0);                         /* -t1 / 2^13 */
+    coeff.t_lin = (float)(8.0 * (double)calibration->t2);                                /* 8 * t2 */
+    coeff.t_quad = (float)calibration->t3;                                               /* t3 */
+    coeff.p_num0 = (float)(1048576.0 - 16.0 * (double)calibration->p4);                  /* 2^20 - 16 * p4 */
+    coeff.p_num1 = (float)((double)calibration->p5 / 8192.0);                            /* p5 / 2^13 */
+    coeff.p_num2 = (float)((double)calibration->p6 / 536870912.0);                       /* p6 / 2^29 */
+    coeff.p_den0 = (float)(p1 / 6250.0);                                                 /* p1 / 6250 */
+    coeff.p_den1 = (float)(p1 * (double)calibration->p2 / 17179869184.0 / 6250.0);       /* p1 * p2 / 2^34 / 6250 */
+    coeff.p_den2 = (float)(p1 * (double)calibration->p3 / 9007199254740992.0 / 6250.0);  /* p1 * p3 / 2^53 / 6250 */
+    coeff.p_out0 = (float)((double)calibration->p7 / 16.0);                              /* p7 / 2^4 */
+    coeff.p_out1 = (float)(1.0 + (double)calibration->p8 / 524288.0);                    /* 1 + p8 / 2^19 */
+    coeff.p_out2 = (float)((double)calibration->p9 / 34359738368.0);                     /* p9 / 2^35 */
+
+    return coeff;                                                                        /* return coefficients */
+}
+
+/**
+ * @brief     compensate raw data with compiled coefficients
+ * @param[in] *coefficients pointer to a bmp280 coefficients structure
+ * @param[in] temperature_raw raw temperature
+ * @param[in] pressure_raw raw pressure
+ * @return    compensated temperature, pressure and t_fine
+ * @note      pure function, safe to call from any thread
+ */
+bmp280_compensation_t bmp280_compensate_compiled(const bmp280_coefficients_t *coefficients,
+                                                 uint32_t temperature_raw, uint32_t pressure_raw)
+{
+    bmp280_compensation_t result;
+
+    result.status = BMP280_COMPENSATE_OK;                                                      /* init ok */
+    if (a_bmp280_compensate_temperature(coefficients, temperature_raw,
+                                        &result.t_fine, &result.temperature_c) != 0)           /* compensate temperature */
+    {
+        result.status |= BMP280_COMPENSATE_TEMPERATURE_RANGE;                                  /* set temperature failed */
+    }
+    if (a_bmp280_compensate_pressure(coefficients, result.t_fine,
+                                     pressure_raw, &result.pressure_pa) != 0)                  /* compensate pressure */
+    {
+        result.status |= BMP280_COMPENSATE_PRESSURE_RANGE;                                     /* set pressure failed */
+    }
+
+    return result;                                                                             /* return result */
+}
+
+/**
+ * @brief     compensate raw data with a calibration
+ * @param[in] *calibration pointer to a bmp280 calibration structure
+ * @param[in] temperature_raw raw temperature
+ * @param[in] pressure_raw raw pressure
+ * @return    compensated temperature, pressure and t_fine
+ * @note      pure function, safe to call from any thread
+ */
+bmp280_compensation_t bmp280_compensate(const bmp280_calibration_t *calibration,
+                                        uint32_t temperature_raw, uint32_t pressure_raw)
+{
+    bmp280_coefficients_t coeff;
+
+    coeff = bmp280_compile_calibration(calibration);                                     /* fold coefficients */
+
+    return bmp280_compensate_compiled(&coeff, temperature_raw, pressure_raw);            /* compensate */
+}
+
+/**
+ * @brief     compensate raw data with a calibration using integer arithmetic
+ * @param[in] *calibration pointer to a bmp280 calibration structure
+ * @param[in] temperature_raw raw temperature
+ * @param[in] pressure_raw raw pressure
+ * @return    compensated temperature, pressure and t_fine
+ * @note      pure function, safe to call from any thread
+ */
+bmp280_compensation_fixed_t bmp280_compensate_fixed(const bmp280_calibration_t *calibration,
+                                                    uint32_t temperature_raw, uint32_t pressure_raw)
+{
+    bmp280_compensation_fixed_t result;
+
+    result.status = BMP280_COMPENSATE_OK;                                                           /* init ok */
+    if (a_bmp280_compensate_temperature_fixed(calibration, temperature_raw,
+                                              &result.t_fine, &result.temperature_centi_c) != 0)    /* compensate temperature */
+    {
+        result.status |= BMP280_COMPENSATE_TEMPERATURE_RANGE;                                       /* set temperature failed */
+    }
+    if (a_bmp280_compensate_pressure_fixed(calibration, result.t_fine,
+                                           pressure_raw, &result.pressure_q24_8) != 0)              /* compensate pressure */
+    {
+        result.status |= BMP280_COMPENSATE_PRESSURE_RANGE;                                          /* set pressure failed */
+    }
+
+    return result;                                                                                  /* return result */
+}
+
 /**
  * @brief     set the chip register
  * @param[in] *handle pointer to a bmp280 handle structure
@@ -1567,16 +2370,25 @@ uint8_t bmp280_read_temperature_pressure(bmp280_handle_t *handle, uint32_t *temp
  */
 uint8_t bmp280_set_reg(bmp280_handle_t *handle, uint8_t reg, uint8_t value)
 {
-    if (handle == NULL)                                          /* check handle */
+    if (handle == NULL)                                                     /* check handle */
+    {
+        return 2;                                                           /* return error */
+    }
+    if (handle->inited != 1)                                                /* check handle initialization */
+    {
+        return 3;                                                           /* return error */
+    }
+
+    if ((reg == BMP280_REG_CTRL_MEAS) || (reg == BMP280_REG_CONFIG))        /* shadowed register */
     {
-        return 2;                                                /* return error */
+        return a_bmp280_shadow_write(handle, reg, value);                   /* write register and shadow */
     }
-    if (handle->inited != 1)                                     /* check handle initialization */
+    if (reg == BMP280_REG_RESET)                                            /* reset register */
     {
-        return 3;                                                /* return error */
+        handle->shadow_valid = 0;                                           /* invalidate the shadow registers */
     }
 
-    return a_bmp280_iic_spi_write(handle, reg, &value, 1);       /* write register */
+    return a_bmp280_iic_spi_write(handle, reg, &value, 1);                  /* write register */
 }
 
 /**
@@ -142,39 +142,134 @@ typedef enum
     BMP280_SPI_WIRE_3 = 0x01,        /**< 3 wire */
 } bmp280_spi_wire_t;
 
+/**
+ * @brief bmp280 compensation status enumeration definition
+ */
+typedef enum
+{
+    BMP280_COMPENSATE_OK                = 0x00,        /**< ok */
+    BMP280_COMPENSATE_TEMPERATURE_RANGE = 0x01,        /**< temperature clamped to -40 - 85 degC */
+    BMP280_COMPENSATE_PRESSURE_RANGE    = 0x02,        /**< pressure clamped to 300 - 1100 hPa */
+} bmp280_compensate_status_t;
+
+/**
+ * @brief bmp280 calibration structure definition
+ */
+typedef struct bmp280_calibration_s
+{
+    uint16_t t1;        /**< t1 register */
+    int16_t t2;         /**< t2 register */
+    int16_t t3;         /**< t3 register */
+    uint16_t p1;        /**< p1 register */
+    int16_t p2;         /**< p2 register */
+    int16_t p3;         /**< p3 register */
+    int16_t p4;         /**< p4 register */
+    int16_t p5;         /**< p5 register */
+    int16_t p6;         /**< p6 register */
+    int16_t p7;         /**< p7 register */
+    int16_t p8;         /**< p8 register */
+    int16_t p9;         /**< p9 register */
+} bmp280_calibration_t;
+
+/**
+ * @brief bmp280 compiled coefficients structure definition
+ * @note  calibration-only terms of the float formulas folded into polynomials:
+ *        x = raw_t / 2^17 + t_offset, t_fine = x * (t_lin + t_quad * x),
+ *        v = t_fine / 2 - 64000,
+ *        p = (p_num0 - raw_p - v * (p_num1 + v * p_num2)) / (p_den0 + v * (p_den1 + v * p_den2)),
+ *        pressure = p_out0 + p * (p_out1 + p_out2 * p)
+ */
+typedef struct bmp280_coefficients_s
+{
+    float t_offset;        /**< -t1 / 2^13 */
+    float t_lin;           /**< 8 * t2 */
+    float t_quad;          /**< t3 */
+    float p_num0;          /**< 2^20 - 16 * p4 */
+    float p_num1;          /**< p5 / 2^13 */
+    float p_num2;          /**< p6 / 2^29 */
+    float p_den0;          /**< p1 / 6250 */
+    float p_den1;          /**< p1 * p2 / 2^34 / 6250 */
+    float p_den2;          /**< p1 * p3 / 2^53 / 6250 */
+    float p_out0;          /**< p7 / 2^4 */
+    float p_out1;          /**< 1 + p8 / 2^19 */
+    float p_out2;          /**< p9 / 2^35 */
+} bmp280_coefficients_t;
+
+/**
+ * @brief bmp280 compensation result structure definition
+ */
+typedef struct bmp280_compensation_s
+{
+    float temperature_c;        /**< temperature in degC */
+    float pressure_pa;          /**< pressure in Pa */
+    int32_t t_fine;             /**< fine temperature shared by the pressure formula */
+    uint8_t status;             /**< bmp280_compensate_status_t flags */
+} bmp280_compensation_t;
+
+/**
+ * @brief bmp280 integer compensation result structure definition
+ */
+typedef struct bmp280_compensation_fixed_s
+{
+    int32_t temperature_centi_c;        /**< temperature in 0.01 degC */
+    uint32_t pressure_q24_8;            /**< pressure in Q24.8 Pa */
+    int32_t t_fine;                     /**< fine temperature shared by the pressure formula */
+    uint8_t status;                     /**< bmp280_compensate_status_t flags */
+} bmp280_compensation_fixed_t;
+
+/**
+ * @brief bmp280 warm state structure definition
+ */
+typedef struct bmp280_warm_state_s
+{
+    uint8_t chip_id;                         /**< chip id */
+    uint8_t ctrl_meas;                       /**< applied ctrl meas register */
+    uint8_t config;                          /**< applied config register */
+    bmp280_calibration_t calibration;        /**< nvm calibration */
+} bmp280_warm_state_t;
+
 /**
  * @brief bmp280 handle structure definition
  */
 typedef struct bmp280_handle_s
 {
     uint8_t iic_addr;                                                                   /**< iic device address */
-    uint8_t (*iic_init)(void);                                                          /**< point to an iic_init function address */
-    uint8_t (*iic_deinit)(void);                                                        /**< point to an iic_deinit function address */
-    uint8_t (*iic_read)(uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);         /**< point to an iic_read function address */
-    uint8_t (*iic_write)(uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);        /**< point to an iic_write function address */
-    uint8_t (*spi_init)(void);                                                          /**< point to a spi_init function address */
-    uint8_t (*spi_deinit)(void);                                                        /**< point to a spi_deinit function address */
-    uint8_t (*spi_read)(uint8_t reg, uint8_t *buf, uint16_t len);                       /**< point to a spi_read function address */
-    uint8_t (*spi_write)(uint8_t reg, uint8_t *buf, uint16_t len);                      /**< point to a spi_write function address */
+    void *bus;                                                                          /**< bus context passed to every link function */
+    uint8_t (*iic_init)(void *bus);                                                     /**< point to an iic_init function address */
+    uint8_t (*iic_deinit)(void *bus);                                                   /**< point to an iic_deinit function address */
+    uint8_t (*iic_read)(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);     /**< point to an iic_read function address */
+    uint8_t (*iic_write)(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);    /**< point to an iic_write function address */
+    uint8_t (*spi_init)(void *bus);                                                     /**< point to a spi_init function address */
+    uint8_t (*spi_deinit)(void *bus);                                                   /**< point to a spi_deinit function address */
+    uint8_t (*spi_read)(void *bus, uint8_t reg, uint8_t *buf, uint16_t len);            /**< point to a spi_read function address */
+    uint8_t (*spi_write)(void *bus, uint8_t reg, uint8_t *buf, uint16_t len);           /**< point to a spi_write function address */
     void (*delay_ms)(uint32_t ms);                                                      /**< point to a delay_ms function address */
+    void (*delay_us)(uint32_t us);                                                      /**< point to a delay_us function address, optional */
     void (*debug_print)(const char *const fmt, ...);                                    /**< point to a debug_print function address */
     uint8_t inited;                                                                     /**< inited flag */
     uint8_t iic_spi;                                                                    /**< iic spi interface */
-    uint16_t t1;                                                                        /**< t1 register */
-    int16_t t2;                                                                         /**< t2 register */
-    int16_t t3;                                                                         /**< t3 register */
-    uint16_t p1;                                                                        /**< p1 register */
-    int16_t p2;                                                                         /**< p2 register */
-    int16_t p3;                                                                         /**< p3 register */
-    int16_t p4;                                                                         /**< p4 register */
-    int16_t p5;                                                                         /**< p5 register */
-    int16_t p6;                                                                         /**< p6 register */
-    int16_t p7;                                                                         /**< p7 register */
-    int16_t p8;                                                                         /**< p8 register */
-    int16_t p9;                                                                         /**< p9 register */
-    int32_t t_fine;                                                                     /**< inner register */
+    bmp280_calibration_t calibration;                                                   /**< nvm calibration */
+    bmp280_coefficients_t coefficients;                                                 /**< calibration folded at init */
+    uint8_t ctrl_meas;                                                                  /**< ctrl meas shadow register */
+    uint8_t config;                                                                     /**< config shadow register */
+    uint8_t shadow_valid;                                                               /**< shadow register valid flags */
 } bmp280_handle_t;
 
+/**
+ * @brief bmp280 sample structure definition
+ */
+typedef struct bmp280_sample_s
+{
+    uint8_t status;                  /**< status register */
+    uint8_t ctrl_meas;               /**< ctrl meas register */
+    uint8_t config;                  /**< config register */
+    uint8_t measuring;               /**< conversion is running */
+    uint8_t im_update;               /**< nvm data is being copied */
+    bmp280_mode_t mode;              /**< current mode */
+    uint32_t temperature_raw;        /**< raw temperature */
+    uint32_t pressure_raw;           /**< raw pressure */
+} bmp280_sample_t;
+
 /**
  * @brief bmp280 information structure definition
  */
@@ -210,6 +305,14 @@ typedef struct bmp280_info_s
  */
 #define DRIVER_BMP280_LINK_INIT(HANDLE, STRUCTURE)          memset(HANDLE, 0, sizeof(STRUCTURE))
 
+/**
+ * @brief     link the bus context
+ * @param[in] HANDLE pointer to a bmp280 handle structure
+ * @param[in] BUS pointer to a bus context handed to every link function
+ * @note      several handles may share one bus context
+ */
+#define DRIVER_BMP280_LINK_BUS(HANDLE, BUS)                (HANDLE)->bus = (void *)(BUS)
+
 /**
  * @brief     link iic_init function
  * @param[in] HANDLE pointer to a bmp280 handle structure
@@ -282,6 +385,14 @@ typedef struct bmp280_info_s
  */
 #define DRIVER_BMP280_LINK_DELAY_MS(HANDLE, FUC)           (HANDLE)->delay_ms = FUC
 
+/**
+ * @brief     link delay_us function
+ * @param[in] HANDLE pointer to a bmp280 handle structure
+ * @param[in] FUC pointer to a delay_us function address
+ * @note      optional, the driver rounds up to delay_ms when it is not linked
+ */
+#define DRIVER_BMP280_LINK_DELAY_US(HANDLE, FUC)           (HANDLE)->delay_us = FUC
+
 /**
  * @brief     link debug_print function
  * @param[in] HANDLE pointer to a bmp280 handle structure
@@ -370,6 +481,36 @@ uint8_t bmp280_get_addr_pin(bmp280_handle_t *handle, bmp280_address_t *addr_pin)
  */
 uint8_t bmp280_init(bmp280_handle_t *handle);
 
+/**
+ * @brief     initialize the chip from a saved warm state
+ * @param[in] *handle pointer to a bmp280 handle structure
+ * @param[in] *state pointer to a bmp280 warm state structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 iic or spi initialization failed
+ *            - 2 handle or state is NULL
+ *            - 3 linked functions is NULL
+ *            - 4 read or write failed
+ *            - 5 state does not match the chip
+ * @note      skips the reset, a single burst read validates the state, nvm
+ *            calibration included, against the chip, on 5 use bmp280_init;
+ *            a saved normal mode is resumed if the chip was put to sleep
+ */
+uint8_t bmp280_init_warm(bmp280_handle_t *handle, const bmp280_warm_state_t *state);
+
+/**
+ * @brief      get the warm state of the chip
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *state pointer to a bmp280 warm state structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 get warm state failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       save it after the configuration has been applied
+ */
+uint8_t bmp280_get_warm_state(bmp280_handle_t *handle, bmp280_warm_state_t *state);
+
 /**
  * @brief     close the chip
  * @param[in] *handle pointer to a bmp280 handle structure
@@ -402,6 +543,131 @@ uint8_t bmp280_deinit(bmp280_handle_t *handle);
 uint8_t bmp280_read_temperature_pressure(bmp280_handle_t *handle, uint32_t *temperature_raw, float *temperature_c, 
                                          uint32_t *pressure_raw, float *pressure_pa);
 
+/**
+ * @brief      read status, control and data registers as one snapshot
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *sample pointer to a bmp280 sample structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       0xF3 - 0xFC are fetched in a single burst, so status, mode and raw data are consistent
+ */
+uint8_t bmp280_read_sample(bmp280_handle_t *handle, bmp280_sample_t *sample);
+
+/**
+ * @brief      compensate the raw data of a sample
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[in]  *sample pointer to a bmp280 sample structure
+ * @param[out] *temperature_c pointer to a converted temperature buffer
+ * @param[out] *pressure_pa pointer to a converted pressure buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 compensate failed
+ * @note       no bus access, so a sample can be compensated while the next conversion runs
+ */
+uint8_t bmp280_compensate_sample(bmp280_handle_t *handle, const bmp280_sample_t *sample,
+                                 float *temperature_c, float *pressure_pa);
+
+/**
+ * @brief      compensate the raw data of a sample with integer arithmetic
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[in]  *sample pointer to a bmp280 sample structure
+ * @param[out] *temperature_centi_c pointer to a converted temperature buffer in 0.01 degC
+ * @param[out] *pressure_q24_8 pointer to a converted pressure buffer in Q24.8 Pa
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 compensate failed
+ * @note       32 bit temperature and 64 bit pressure formulas of the Bosch reference,
+ *             no floating point, results are bit-exact across builds
+ */
+uint8_t bmp280_compensate_sample_fixed(bmp280_handle_t *handle, const bmp280_sample_t *sample,
+                                       int32_t *temperature_centi_c, uint32_t *pressure_q24_8);
+
+/**
+ * @brief      get the calibration data
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *calibration pointer to a bmp280 calibration structure
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       the copy can be compensated against without the handle
+ */
+uint8_t bmp280_get_calibration(bmp280_handle_t *handle, bmp280_calibration_t *calibration);
+
+/**
+ * @brief     fold a calibration into compensation coefficients
+ * @param[in] *calibration pointer to a bmp280 calibration structure
+ * @return    compiled coefficients
+ * @note      bmp280_init builds the block for its handle, offline users
+ *            compile once per calibration and reuse the result
+ */
+bmp280_coefficients_t bmp280_compile_calibration(const bmp280_calibration_t *calibration);
+
+/**
+ * @brief     compensate raw data with compiled coefficients
+ * @param[in] *coefficients pointer to a bmp280 coefficients structure
+ * @param[in] temperature_raw raw temperature
+ * @param[in] pressure_raw raw pressure
+ * @return    compensated temperature, pressure and t_fine, status holds
+ *            bmp280_compensate_status_t flags for clamped values
+ * @note      pure function, a chain of multiply-adds and one divide per sample
+ */
+bmp280_compensation_t bmp280_compensate_compiled(const bmp280_coefficients_t *coefficients,
+                                                 uint32_t temperature_raw, uint32_t pressure_raw);
+
+/**
+ * @brief     compensate raw data with a calibration
+ * @param[in] *calibration pointer to a bmp280 calibration structure
+ * @param[in] temperature_raw raw temperature
+ * @param[in] pressure_raw raw pressure
+ * @return    compensated temperature, pressure and t_fine, status holds
+ *            bmp280_compensate_status_t flags for clamped values
+ * @note      pure function with no handle or shared state, safe to call
+ *            concurrently and on archived raw data, folds the calibration
+ *            on every call, see bmp280_compile_calibration
+ */
+bmp280_compensation_t bmp280_compensate(const bmp280_calibration_t *calibration,
+                                        uint32_t temperature_raw, uint32_t pressure_raw);
+
+/**
+ * @brief     compensate raw data with a calibration using integer arithmetic
+ * @param[in] *calibration pointer to a bmp280 calibration structure
+ * @param[in] temperature_raw raw temperature
+ * @param[in] pressure_raw raw pressure
+ * @return    compensated temperature, pressure and t_fine, status holds
+ *            bmp280_compensate_status_t flags for clamped values
+ * @note      pure function with no handle or shared state, safe to call
+ *            concurrently and on archived raw data
+ */
+bmp280_compensation_fixed_t bmp280_compensate_fixed(const bmp280_calibration_t *calibration,
+                                                    uint32_t temperature_raw, uint32_t pressure_raw);
+
+/**
+ * @brief      compensate arrays of raw samples
+ * @param[in]  *calibration pointer to a bmp280 calibration structure
+ * @param[in]  *temperature_raw pointer to a raw temperature array
+ * @param[in]  *pressure_raw pointer to a raw pressure array
+ * @param[out] *temperature_c pointer to a temperature array
+ * @param[out] *pressure_pa pointer to a pressure array
+ * @param[out] *status pointer to a bmp280_compensate_status_t flags array, may be NULL
+ * @param[in]  count number of samples
+ * @return     number of samples with a clamped value
+ * @note       structure-of-arrays form of bmp280_compensate, vectorized with
+ *             avx2 or sse2 on x86 and neon on aarch64 with a scalar tail,
+ *             results are bit-identical to the scalar path when both are
+ *             built with -ffp-contract=off
+ */
+uint32_t bmp280_compensate_batch(const bmp280_calibration_t *calibration,
+                                 const uint32_t *temperature_raw, const uint32_t *pressure_raw,
+                                 float *temperature_c, float *pressure_pa, uint8_t *status, uint32_t count);
+
 /**
  * @brief      read the pressure data
  * @param[in]  *handle pointer to a bmp280 handle structure
@@ -459,6 +725,45 @@ uint8_t bmp280_soft_reset(bmp280_handle_t *handle);
  */
 uint8_t bmp280_get_status(bmp280_handle_t *handle, uint8_t *status);
 
+/**
+ * @brief      get the maximum measurement time of one conversion
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *us pointer to a measurement time buffer in microseconds
+ * @return     status code
+ *             - 0 success
+ *             - 1 get measure time failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       t_measure,max = 1.25 ms + 2.3 ms * osrs_t + (2.3 ms * osrs_p + 0.575 ms) from the datasheet
+ */
+uint8_t bmp280_get_measure_time_us(bmp280_handle_t *handle, uint32_t *us);
+
+/**
+ * @brief      get the normal mode standby time
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *us pointer to a standby time buffer in microseconds
+ * @return     status code
+ *             - 0 success
+ *             - 1 get standby time failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       t_standby of the config register
+ */
+uint8_t bmp280_get_standby_time_us(bmp280_handle_t *handle, uint32_t *us);
+
+/**
+ * @brief      get the normal mode output data period
+ * @param[in]  *handle pointer to a bmp280 handle structure
+ * @param[out] *us pointer to a period buffer in microseconds
+ * @return     status code
+ *             - 0 success
+ *             - 1 get period failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       t_measure,typ + t_standby, t_measure,typ = 1 ms + 2 ms * osrs_t + (2 ms * osrs_p + 0.5 ms)
+ */
+uint8_t bmp280_get_normal_period_us(bmp280_handle_t *handle, uint32_t *us);
+
 /**
  * @brief     set temperatue oversampling
  * @param[in] *handle pointer to a bmp280 handle structure
@@ -0,0 +1,468 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_bmp280.hpp
+ * @brief     driver bmp280 header-only c++ driver
+ * @version   1.0.0
+ * @author    Atmospheric Monitor
+ * @date      2026-10-17
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author               <th>Description
+ * <tr><td>2026/10/17  <td>1.0      <td>Atmospheric Monitor  <td>header-only bus policy driver
+ * </table>
+ */
+
+#ifndef DRIVER_BMP280_HPP
+#define DRIVER_BMP280_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "driver_bmp280.h"
+
+/*
+ * The C driver in driver_bmp280.c dispatches every transfer through the
+ * function pointers linked into bmp280_handle_t. This driver is templated on
+ * a Bus policy instead, so the transfer, the decode and the compensation of
+ * a read all inline into the caller. Enumerations, calibration and result
+ * structures are shared with the C driver, which stays the reference: the
+ * compensation below evaluates bmp280_compensate_compiled() operation for
+ * operation and gives bit-identical results, provided the including file is
+ * built with -ffp-contract=off like driver_bmp280.c.
+ *
+ * A Bus provides
+ *
+ *     uint8_t read(uint8_t reg, uint8_t *buf, uint16_t len);
+ *     uint8_t write(uint8_t reg, const uint8_t *buf, uint16_t len);
+ *     void delay_us(uint32_t us);
+ *
+ * with 0 meaning success, like the interface callbacks.
+ */
+namespace bmp280 {
+
+/**
+ * @brief register address
+ */
+template <uint8_t Address>
+struct Register
+{
+    static constexpr uint8_t address = Address;
+};
+
+struct RegCalibration : Register<0x88> { static constexpr uint16_t length = 24; };
+struct RegId : Register<0xD0> { static constexpr uint8_t chip_id = 0x58; };
+struct RegReset : Register<0xE0> { static constexpr uint8_t command = 0xB6; };
+struct RegStatus : Register<0xF3> {};
+struct RegCtrlMeas : Register<0xF4> {};
+struct RegConfig : Register<0xF5> {};
+struct RegData : Register<0xF7> { static constexpr uint16_t length = 6; };
+
+/**
+ * @brief bit field of a register
+ */
+template <class Reg, unsigned Shift, unsigned Width>
+struct Field
+{
+    using reg = Reg;
+    static constexpr uint8_t mask = (uint8_t)(((1u << Width) - 1u) << Shift);
+
+    static constexpr uint8_t encode(unsigned value) { return (uint8_t)((value << Shift) & mask); }
+    static constexpr unsigned decode(uint8_t value) { return (unsigned)(value & mask) >> Shift; }
+};
+
+using StatusMeasuring = Field<RegStatus, 3, 1>;
+using StatusImUpdate = Field<RegStatus, 0, 1>;
+using CtrlOsrsT = Field<RegCtrlMeas, 5, 3>;
+using CtrlOsrsP = Field<RegCtrlMeas, 2, 3>;
+using CtrlMode = Field<RegCtrlMeas, 0, 2>;
+using ConfigStandby = Field<RegConfig, 5, 3>;
+using ConfigFilter = Field<RegConfig, 2, 3>;
+using ConfigSpi3w = Field<RegConfig, 0, 1>;
+
+/**
+ * @brief oversampling factor of an osrs field value
+ */
+constexpr uint32_t oversampling_factor(unsigned osrs)
+{
+    return osrs == 0 ? 0 : osrs >= 5 ? 16 : 1u << (osrs - 1);
+}
+
+/**
+ * @brief     maximum measurement time for a ctrl meas value
+ * @param[in] ctrl_meas ctrl meas register value
+ * @return    measurement time in microseconds
+ * @note      same formula as the c driver
+ */
+constexpr uint32_t measure_time_us(uint8_t ctrl_meas)
+{
+    return 1250 + 2300 * oversampling_factor(CtrlOsrsT::decode(ctrl_meas)) +
+           (oversampling_factor(CtrlOsrsP::decode(ctrl_meas)) != 0
+                ? 2300 * oversampling_factor(CtrlOsrsP::decode(ctrl_meas)) + 575 : 0);
+}
+
+/**
+ * @brief configuration preset, every register word is a compile-time constant
+ */
+template <bmp280_oversampling_t Temperature, bmp280_oversampling_t Pressure, bmp280_mode_t Mode,
+          bmp280_standby_time_t Standby = BMP280_STANDBY_TIME_0P5_MS, bmp280_filter_t Filter = BMP280_FILTER_OFF>
+struct Preset
+{
+    static constexpr bmp280_mode_t mode = Mode;
+    static constexpr uint8_t ctrl_meas = CtrlOsrsT::encode(Temperature) | CtrlOsrsP::encode(Pressure) |
+                                         CtrlMode::encode(Mode);
+    static constexpr uint8_t config = ConfigStandby::encode(Standby) | ConfigFilter::encode(Filter);
+    static constexpr uint32_t measure_us = measure_time_us(ctrl_meas);
+};
+
+static_assert(Preset<BMP280_OVERSAMPLING_x1, BMP280_OVERSAMPLING_x1, BMP280_MODE_NORMAL>::ctrl_meas == 0x27,
+              "ctrl meas layout");
+static_assert(Preset<BMP280_OVERSAMPLING_x1, BMP280_OVERSAMPLING_x1, BMP280_MODE_NORMAL>::measure_us == 6425,
+              "measurement time");
+
+/**
+ * @brief     fold a calibration into compensation coefficients
+ * @param[in] &calibration bmp280 calibration structure
+ * @return    compiled coefficients
+ * @note      same folding as bmp280_compile_calibration
+ */
+inline bmp280_coefficients_t compile(const bmp280_calibration_t &calibration)
+{
+    bmp280_coefficients_t coeff;
+    double p1 = (double)calibration.p1;
+
+    coeff.t_offset = (float)(-(double)calibration.t1 / 8192.0);
+    coeff.t_lin = (float)(8.0 * (double)calibration.t2);
+    coeff.t_quad = (float)calibration.t3;
+    coeff.p_num0 = (float)(1048576.0 - 16.0 * (double)calibration.p4);
+    coeff.p_num1 = (float)((double)calibration.p5 / 8192.0);
+    coeff.p_num2 = (float)((double)calibration.p6 / 536870912.0);
+    coeff.p_den0 = (float)(p1 / 6250.0);
+    coeff.p_den1 = (float)(p1 * (double)calibration.p2 / 17179869184.0 / 6250.0);
+    coeff.p_den2 = (float)(p1 * (double)calibration.p3 / 9007199254740992.0 / 6250.0);
+    coeff.p_out0 = (float)((double)calibration.p7 / 16.0);
+    coeff.p_out1 = (float)(1.0 + (double)calibration.p8 / 524288.0);
+    coeff.p_out2 = (float)((double)calibration.p9 / 34359738368.0);
+    return coeff;
+}
+
+/**
+ * @brief     compensate raw data with compiled coefficients
+ * @param[in] &coeff bmp280 coefficients structure
+ * @param[in] temperature_raw raw temperature
+ * @param[in] pressure_raw raw pressure
+ * @return    compensated temperature, pressure and t_fine
+ * @note      bit-identical with bmp280_compensate_compiled
+ */
+inline bmp280_compensation_t compensate(const bmp280_coefficients_t &coeff, uint32_t temperature_raw,
+                                        uint32_t pressure_raw)
+{
+    bmp280_compensation_t result;
+
+    result.status = BMP280_COMPENSATE_OK;
+    float x = (float)temperature_raw * (1.0f / 131072.0f) + coeff.t_offset;
+    float sum = x * (coeff.t_lin + coeff.t_quad * x);
+    result.t_fine = (int32_t)sum;
+    float temperature = sum * (1.0f / 5120.0f);
+    if (temperature < -40.0f || temperature > 85.0f)
+    {
+        temperature = temperature < -40.0f ? -40.0f : 85.0f;
+        result.status |= BMP280_COMPENSATE_TEMPERATURE_RANGE;
+    }
+    result.temperature_c = temperature;
+
+    float v = (float)result.t_fine * 0.5f - 64000.0f;
+    float den = coeff.p_den0 + v * (coeff.p_den1 + v * coeff.p_den2);
+    if (den == 0.0f)
+    {
+        result.pressure_pa = 0.0f;
+        result.status |= BMP280_COMPENSATE_PRESSURE_RANGE;
+        return result;
+    }
+    float num = (coeff.p_num0 - (float)pressure_raw) - v * (coeff.p_num1 + v * coeff.p_num2);
+    float pressure = num / den;
+    pressure = coeff.p_out0 + pressure * (coeff.p_out1 + coeff.p_out2 * pressure);
+    if (pressure < 30000.0f || pressure > 110000.0f)
+    {
+        pressure = pressure < 30000.0f ? 30000.0f : 110000.0f;
+        result.status |= BMP280_COMPENSATE_PRESSURE_RANGE;
+    }
+    result.pressure_pa = pressure;
+    return result;
+}
+
+/**
+ * @brief longest register write, every control register is written on its own
+ */
+static constexpr uint16_t max_write_length = 1;
+
+/**
+ * @brief linux i2c-dev bus, one device per bus object
+ */
+class LinuxI2CBus
+{
+public:
+    LinuxI2CBus(const char *path, uint8_t addr) : fd_(open(path, O_RDWR)), addr_(addr) {}
+    ~LinuxI2CBus() { if (fd_ >= 0) close(fd_); }
+    LinuxI2CBus(const LinuxI2CBus &) = delete;
+    LinuxI2CBus &operator=(const LinuxI2CBus &) = delete;
+
+    bool is_open() const { return fd_ >= 0; }
+
+    uint8_t read(uint8_t reg, uint8_t *buf, uint16_t len)
+    {
+        struct i2c_msg msgs[2] = {{addr_, 0, 1, &reg}, {addr_, I2C_M_RD, len, buf}};
+        struct i2c_rdwr_ioctl_data xfer = {msgs, 2};
+        return ioctl(fd_, I2C_RDWR, &xfer) == 2 ? 0 : 1;
+    }
+
+    uint8_t write(uint8_t reg, const uint8_t *buf, uint16_t len)
+    {
+        uint8_t tmp[1 + max_write_length];
+        if (len == 0 || len > max_write_length)
+            return 1;
+        tmp[0] = reg;
+        memcpy(tmp + 1, buf, len);
+        struct i2c_msg msg = {addr_, 0, (uint16_t)(len + 1), tmp};
+        struct i2c_rdwr_ioctl_data xfer = {&msg, 1};
+        return ioctl(fd_, I2C_RDWR, &xfer) == 1 ? 0 : 1;
+    }
+
+    void delay_us(uint32_t us) { usleep(us); }
+
+private:
+    int fd_;
+    uint16_t addr_;
+};
+
+/**
+ * @brief bus over the c iic interface callbacks of one device
+ * @note  wraps bmp280_interface_iic_*, bmp280_interface_sim_iic_* or
+ *        bmp280_interface_replay_iic_* with the matching bus context, so the
+ *        header-only driver runs on the simulator and on recorded traces
+ */
+class IICCallbackBus
+{
+public:
+    typedef uint8_t (*transfer_t)(void *bus, uint8_t addr, uint8_t reg, uint8_t *buf, uint16_t len);
+    typedef void (*delay_t)(uint32_t us);
+
+    IICCallbackBus(void *bus, uint8_t addr, transfer_t read, transfer_t write, delay_t delay_us)
+        : bus_(bus), addr_(addr), read_(read), write_(write), delay_us_(delay_us) {}
+
+    uint8_t read(uint8_t reg, uint8_t *buf, uint16_t len) { return read_(bus_, addr_, reg, buf, len); }
+
+    uint8_t write(uint8_t reg, const uint8_t *buf, uint16_t len)
+    {
+        uint8_t tmp[max_write_length];
+        if (len == 0 || len > max_write_length)
+            return 1;
+        memcpy(tmp, buf, len);
+        return write_(bus_, addr_, reg, tmp, len);
+    }
+
+    void delay_us(uint32_t us) { delay_us_(us); }
+
+private:
+    void *bus_;
+    uint8_t addr_;
+    transfer_t read_;
+    transfer_t write_;
+    delay_t delay_us_;
+};
+
+/**
+ * @brief bus over the c spi interface callbacks of one device
+ * @note  wraps bmp280_interface_spi_read and bmp280_interface_spi_write on a
+ *        bmp280_interface_spi_bus_t, spidev or any transfer hook linked into it
+ */
+class SPICallbackBus
+{
+public:
+    typedef uint8_t (*transfer_t)(void *bus, uint8_t reg, uint8_t *buf, uint16_t len);
+    typedef void (*delay_t)(uint32_t us);
+
+    SPICallbackBus(void *bus, transfer_t read, transfer_t write, delay_t delay_us)
+        : bus_(bus), read_(read), write_(write), delay_us_(delay_us) {}
+
+    uint8_t read(uint8_t reg, uint8_t *buf, uint16_t len) { return read_(bus_, reg, buf, len); }
+
+    uint8_t write(uint8_t reg, const uint8_t *buf, uint16_t len)
+    {
+        uint8_t tmp[max_write_length];
+        if (len == 0 || len > max_write_length)
+            return 1;
+        memcpy(tmp, buf, len);
+        return write_(bus_, reg, tmp, len);
+    }
+
+    void delay_us(uint32_t us) { delay_us_(us); }
+
+private:
+    void *bus_;
+    transfer_t read_;
+    transfer_t write_;
+    delay_t delay_us_;
+};
+
+/**
+ * @brief bmp280 driver on a bus policy
+ */
+template <class Bus>
+class Driver
+{
+public:
+    explicit Driver(Bus &bus) : bus_(bus), calibration_{}, coefficients_{}, ctrl_meas_(0) {}
+
+    /**
+     * @brief  check the chip id, soft reset and read the calibration
+     * @return status code
+     *         - 0 success
+     *         - 4 id is error
+     *         - 5 reset failed
+     *         - 6 read calibration failed
+     * @note   status codes follow bmp280_init
+     */
+    uint8_t init()
+    {
+        uint8_t id;
+        if (bus_.read(RegId::address, &id, 1) != 0 || id != RegId::chip_id)
+            return 4;
+        if (bus_.write(RegReset::address, &RegReset::command, 1) != 0)
+            return 5;
+        bus_.delay_us(5000);
+        uint8_t buf[RegCalibration::length];
+        if (bus_.read(RegCalibration::address, buf, sizeof(buf)) != 0)
+            return 6;
+        calibration_.t1 = (uint16_t)(buf[1] << 8 | buf[0]);
+        calibration_.t2 = (int16_t)(buf[3] << 8 | buf[2]);
+        calibration_.t3 = (int16_t)(buf[5] << 8 | buf[4]);
+        calibration_.p1 = (uint16_t)(buf[7] << 8 | buf[6]);
+        calibration_.p2 = (int16_t)(buf[9] << 8 | buf[8]);
+        calibration_.p3 = (int16_t)(buf[11] << 8 | buf[10]);
+        calibration_.p4 = (int16_t)(buf[13] << 8 | buf[12]);
+        calibration_.p5 = (int16_t)(buf[15] << 8 | buf[14]);
+        calibration_.p6 = (int16_t)(buf[17] << 8 | buf[16]);
+        calibration_.p7 = (int16_t)(buf[19] << 8 | buf[18]);
+        calibration_.p8 = (int16_t)(buf[21] << 8 | buf[20]);
+        calibration_.p9 = (int16_t)(buf[23] << 8 | buf[22]);
+        coefficients_ = compile(calibration_);
+        ctrl_meas_ = 0;
+        return 0;
+    }
+
+    /**
+     * @brief  apply a preset
+     * @return status code
+     *         - 0 success
+     *         - 1 write failed
+     * @note   config first, it is only guaranteed to stick outside normal mode
+     */
+    template <class P>
+    uint8_t configure()
+    {
+        if (bus_.write(RegConfig::address, &P::config, 1) != 0)
+            return 1;
+        if (bus_.write(RegCtrlMeas::address, &P::ctrl_meas, 1) != 0)
+            return 1;
+        ctrl_meas_ = P::ctrl_meas;
+        return 0;
+    }
+
+    /**
+     * @brief      read and compensate the latest result
+     * @param[out] &result compensation result
+     * @return     status code
+     *             - 0 success
+     *             - 1 read failed
+     *             - 4 compensate failed
+     * @note       one burst of 0xF7 - 0xFC, for normal mode
+     */
+    uint8_t read(bmp280_compensation_t &result)
+    {
+        uint8_t buf[RegData::length];
+        if (bus_.read(RegData::address, buf, sizeof(buf)) != 0)
+            return 1;
+        result = decode(buf);
+        return result.status == BMP280_COMPENSATE_OK ? 0 : 4;
+    }
+
+    /**
+     * @brief      run one forced conversion and compensate it
+     * @param[out] &result compensation result
+     * @return     status code
+     *             - 0 success
+     *             - 1 read failed
+     *             - 4 compensate failed
+     *             - 5 read timeout
+     * @note       the oversampling of the preset applied last is used
+     */
+    uint8_t measure(bmp280_compensation_t &result)
+    {
+        uint8_t ctrl_meas = (uint8_t)((ctrl_meas_ & ~CtrlMode::mask) | CtrlMode::encode(BMP280_MODE_FORCED));
+        if (bus_.write(RegCtrlMeas::address, &ctrl_meas, 1) != 0)
+            return 1;
+        bus_.delay_us(measure_time_us(ctrl_meas));
+
+        // Status, ctrl meas and config are read along with the data so a
+        // finished conversion costs a single burst
+        uint8_t window[10];
+        for (uint32_t timeout = 10 * 1000; timeout != 0; timeout--)
+        {
+            if (bus_.read(RegStatus::address, window, sizeof(window)) != 0)
+                return 1;
+            if (CtrlMode::decode(window[1]) == BMP280_MODE_SLEEP && StatusMeasuring::decode(window[0]) == 0)
+            {
+                result = decode(&window[4]);
+                return result.status == BMP280_COMPENSATE_OK ? 0 : 4;
+            }
+            bus_.delay_us(1000);
+        }
+        return 5;
+    }
+
+    const bmp280_calibration_t &calibration() const { return calibration_; }
+    const bmp280_coefficients_t &coefficients() const { return coefficients_; }
+
+private:
+    bmp280_compensation_t decode(const uint8_t *buf) const
+    {
+        uint32_t pressure_raw = (uint32_t)buf[0] << 12 | (uint32_t)buf[1] << 4 | (uint32_t)buf[2] >> 4;
+        uint32_t temperature_raw = (uint32_t)buf[3] << 12 | (uint32_t)buf[4] << 4 | (uint32_t)buf[5] >> 4;
+        return compensate(coefficients_, temperature_raw, pressure_raw);
+    }
+
+    Bus &bus_;
+    bmp280_calibration_t calibration_;
+    bmp280_coefficients_t coefficients_;
+    uint8_t ctrl_meas_;
+};
+
+}
+
+#endif
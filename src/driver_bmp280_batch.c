@@ -0,0 +1,404 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @file      driver_bmp280_batch.c
+ * @brief     driver bmp280 batch compensation source file
+ * @version   1.0.0
+ * @author    Atmospheric Monitor
+ * @date      2026-10-17
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author               <th>Description
+ * <tr><td>2026/10/17  <td>1.0      <td>Atmospheric Monitor  <td>batch compensation kernels
+ * </table>
+ */
+
+#include "driver_bmp280.h"
+
+/*
+ * Every kernel evaluates the folded polynomials of bmp280_compensate_compiled()
+ * operation for operation in the same order and without fused multiply-add,
+ * so a batch result is bit-identical to the scalar path for the same input.
+ * That holds only while the compiler does not contract the scalar or the
+ * vector expressions into fma either, so this file and driver_bmp280.c are
+ * built with -ffp-contract=off (aarch64 gcc contracts by default).
+ */
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define BMP280_BATCH_X86
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define BMP280_BATCH_NEON
+#endif
+
+/**
+ * @brief      compensate samples one at a time
+ * @param[in]  *coeff pointer to a bmp280 coefficients structure
+ * @param[in]  *temperature_raw pointer to a raw temperature array
+ * @param[in]  *pressure_raw pointer to a raw pressure array
+ * @param[out] *temperature_c pointer to a temperature array
+ * @param[out] *pressure_pa pointer to a pressure array
+ * @param[out] *status pointer to a status array, may be NULL
+ * @param[in]  count number of samples
+ * @return     number of samples with a clamped value
+ * @note       none
+ */
+static uint32_t a_bmp280_batch_scalar(const bmp280_coefficients_t *coeff,
+                                      const uint32_t *temperature_raw, const uint32_t *pressure_raw,
+                                      float *temperature_c, float *pressure_pa, uint8_t *status, uint32_t count)
+{
+    uint32_t i;
+    uint32_t clamped;
+    bmp280_compensation_t result;
+
+    clamped = 0;                                                                                /* init 0 */
+    for (i = 0; i < count; i++)                                                                 /* every sample */
+    {
+        result = bmp280_compensate_compiled(coeff, temperature_raw[i], pressure_raw[i]);        /* compensate */
+        temperature_c[i] = result.temperature_c;                                                /* set temperature */
+        pressure_pa[i] = result.pressure_pa;                                                    /* set pressure */
+        if (status != NULL)                                                                     /* check status */
+        {
+            status[i] = result.status;                                                          /* set status */
+        }
+        clamped += (result.status != BMP280_COMPENSATE_OK) ? 1 : 0;                             /* count clamped */
+    }
+
+    return clamped;                                                                             /* return clamped */
+}
+
+#if defined(BMP280_BATCH_X86)
+
+/**
+ * @brief      store the lane flags of one vector
+ * @param[out] *status pointer to a status array, may be NULL
+ * @param[in]  t_bits temperature clamp lane mask
+ * @param[in]  p_bits pressure clamp lane mask
+ * @param[in]  lanes number of lanes
+ * @return     number of samples with a clamped value
+ * @note       none
+ */
+static uint32_t a_bmp280_batch_flags(uint8_t *status, int t_bits, int p_bits, uint32_t lanes)
+{
+    uint32_t i;
+    uint32_t clamped;
+    uint8_t flags;
+
+    clamped = 0;                                                                                /* init 0 */
+    for (i = 0; i < lanes; i++)                                                                 /* every lane */
+    {
+        flags = (uint8_t)((((t_bits >> i) & 1) ? BMP280_COMPENSATE_TEMPERATURE_RANGE : 0) |
+                          (((p_bits >> i) & 1) ? BMP280_COMPENSATE_PRESSURE_RANGE : 0));        /* lane flags */
+        if (status != NULL)                                                                     /* check status */
+        {
+            status[i] = flags;                                                                  /* set status */
+        }
+        clamped += (flags != 0) ? 1 : 0;                                                        /* count clamped */
+    }
+
+    return clamped;                                                                             /* return clamped */
+}
+
+/**
+ * @brief      compensate samples four at a time with sse2
+ * @param[in]  *coeff pointer to a bmp280 coefficients structure
+ * @param[in]  *temperature_raw pointer to a raw temperature array
+ * @param[in]  *pressure_raw pointer to a raw pressure array
+ * @param[out] *temperature_c pointer to a temperature array
+ * @param[out] *pressure_pa pointer to a pressure array
+ * @param[out] *status pointer to a status array, may be NULL
+ * @param[in]  count number of samples, a multiple of 4
+ * @return     number of samples with a clamped value
+ * @note       none
+ */
+static uint32_t a_bmp280_batch_sse2(const bmp280_coefficients_t *coeff,
+                                    const uint32_t *temperature_raw, const uint32_t *pressure_raw,
+                                    float *temperature_c, float *pressure_pa, uint8_t *status, uint32_t count)
+{
+    const __m128 t_offset = _mm_set1_ps(coeff->t_offset);
+    const __m128 t_lin = _mm_set1_ps(coeff->t_lin);
+    const __m128 t_quad = _mm_set1_ps(coeff->t_quad);
+    const __m128 p_num0 = _mm_set1_ps(coeff->p_num0);
+    const __m128 p_num1 = _mm_set1_ps(coeff->p_num1);
+    const __m128 p_num2 = _mm_set1_ps(coeff->p_num2);
+    const __m128 p_den0 = _mm_set1_ps(coeff->p_den0);
+    const __m128 p_den1 = _mm_set1_ps(coeff->p_den1);
+    const __m128 p_den2 = _mm_set1_ps(coeff->p_den2);
+    const __m128 p_out0 = _mm_set1_ps(coeff->p_out0);
+    const __m128 p_out1 = _mm_set1_ps(coeff->p_out1);
+    const __m128 p_out2 = _mm_set1_ps(coeff->p_out2);
+    const __m128 t_min = _mm_set1_ps(-40.0f);
+    const __m128 t_max = _mm_set1_ps(85.0f);
+    const __m128 p_min = _mm_set1_ps(30000.0f);
+    const __m128 p_max = _mm_set1_ps(110000.0f);
+    uint32_t i;
+    uint32_t clamped;
+
+    clamped = 0;
+    for (i = 0; i < count; i += 4)
+    {
+        __m128 raw_t = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(temperature_raw + i)));
+        __m128 raw_p = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(pressure_raw + i)));
+        __m128 x, sum, t_fine, t, v, num, den, p, bad_t, bad_p, div0;
+
+        /* temperature */
+        x = _mm_add_ps(_mm_mul_ps(raw_t, _mm_set1_ps(1.0f / 131072.0f)), t_offset);
+        sum = _mm_mul_ps(x, _mm_add_ps(t_lin, _mm_mul_ps(t_quad, x)));
+        t_fine = _mm_cvtepi32_ps(_mm_cvttps_epi32(sum));
+        t = _mm_mul_ps(sum, _mm_set1_ps(1.0f / 5120.0f));
+        bad_t = _mm_or_ps(_mm_cmplt_ps(t, t_min), _mm_cmpgt_ps(t, t_max));
+        t = _mm_min_ps(_mm_max_ps(t, t_min), t_max);
+
+        /* pressure */
+        v = _mm_sub_ps(_mm_mul_ps(t_fine, _mm_set1_ps(0.5f)), _mm_set1_ps(64000.0f));
+        den = _mm_add_ps(p_den0, _mm_mul_ps(v, _mm_add_ps(p_den1, _mm_mul_ps(v, p_den2))));
+        num = _mm_sub_ps(_mm_sub_ps(p_num0, raw_p), _mm_mul_ps(v, _mm_add_ps(p_num1, _mm_mul_ps(v, p_num2))));
+        p = _mm_div_ps(num, den);
+        p = _mm_add_ps(p_out0, _mm_mul_ps(p, _mm_add_ps(p_out1, _mm_mul_ps(p_out2, p))));
+        div0 = _mm_cmpeq_ps(den, _mm_setzero_ps());
+        bad_p = _mm_or_ps(div0, _mm_or_ps(_mm_cmplt_ps(p, p_min), _mm_cmpgt_ps(p, p_max)));
+        p = _mm_andnot_ps(div0, _mm_min_ps(_mm_max_ps(p, p_min), p_max));
+
+        _mm_storeu_ps(temperature_c + i, t);
+        _mm_storeu_ps(pressure_pa + i, p);
+        clamped += a_bmp280_batch_flags(status != NULL ? status + i : NULL,
+                                        _mm_movemask_ps(bad_t), _mm_movemask_ps(bad_p), 4);
+    }
+
+    return clamped;
+}
+
+#if defined(__GNUC__)
+
+/**
+ * @brief      compensate samples eight at a time with avx2
+ * @param[in]  *coeff pointer to a bmp280 coefficients structure
+ * @param[in]  *temperature_raw pointer to a raw temperature array
+ * @param[in]  *pressure_raw pointer to a raw pressure array
+ * @param[out] *temperature_c pointer to a temperature array
+ * @param[out] *pressure_pa pointer to a pressure array
+ * @param[out] *status pointer to a status array, may be NULL
+ * @param[in]  count number of samples, a multiple of 8
+ * @return     number of samples with a clamped value
+ * @note       built for avx2 only, selected at run time when the cpu has it
+ */
+__attribute__((target("avx2")))
+static uint32_t a_bmp280_batch_avx2(const bmp280_coefficients_t *coeff,
+                                    const uint32_t *temperature_raw, const uint32_t *pressure_raw,
+                                    float *temperature_c, float *pressure_pa, uint8_t *status, uint32_t count)
+{
+    const __m256 t_offset = _mm256_set1_ps(coeff->t_offset);
+    const __m256 t_lin = _mm256_set1_ps(coeff->t_lin);
+    const __m256 t_quad = _mm256_set1_ps(coeff->t_quad);
+    const __m256 p_num0 = _mm256_set1_ps(coeff->p_num0);
+    const __m256 p_num1 = _mm256_set1_ps(coeff->p_num1);
+    const __m256 p_num2 = _mm256_set1_ps(coeff->p_num2);
+    const __m256 p_den0 = _mm256_set1_ps(coeff->p_den0);
+    const __m256 p_den1 = _mm256_set1_ps(coeff->p_den1);
+    const __m256 p_den2 = _mm256_set1_ps(coeff->p_den2);
+    const __m256 p_out0 = _mm256_set1_ps(coeff->p_out0);
+    const __m256 p_out1 = _mm256_set1_ps(coeff->p_out1);
+    const __m256 p_out2 = _mm256_set1_ps(coeff->p_out2);
+    const __m256 t_min = _mm256_set1_ps(-40.0f);
+    const __m256 t_max = _mm256_set1_ps(85.0f);
+    const __m256 p_min = _mm256_set1_ps(30000.0f);
+    const __m256 p_max = _mm256_set1_ps(110000.0f);
+    uint32_t i;
+    uint32_t clamped;
+
+    clamped = 0;
+    for (i = 0; i < count; i += 8)
+    {
+        __m256 raw_t = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(temperature_raw + i)));
+        __m256 raw_p = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(pressure_raw + i)));
+        __m256 x, sum, t_fine, t, v, num, den, p, bad_t, bad_p, div0;
+
+        /* temperature */
+        x = _mm256_add_ps(_mm256_mul_ps(raw_t, _mm256_set1_ps(1.0f / 131072.0f)), t_offset);
+        sum = _mm256_mul_ps(x, _mm256_add_ps(t_lin, _mm256_mul_ps(t_quad, x)));
+        t_fine = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(sum));
+        t = _mm256_mul_ps(sum, _mm256_set1_ps(1.0f / 5120.0f));
+        bad_t = _mm256_or_ps(_mm256_cmp_ps(t, t_min, _CMP_LT_OQ), _mm256_cmp_ps(t, t_max, _CMP_GT_OQ));
+        t = _mm256_min_ps(_mm256_max_ps(t, t_min), t_max);
+
+        /* pressure */
+        v = _mm256_sub_ps(_mm256_mul_ps(t_fine, _mm256_set1_ps(0.5f)), _mm256_set1_ps(64000.0f));
+        den = _mm256_add_ps(p_den0, _mm256_mul_ps(v, _mm256_add_ps(p_den1, _mm256_mul_ps(v, p_den2))));
+        num = _mm256_sub_ps(_mm256_sub_ps(p_num0, raw_p), _mm256_mul_ps(v, _mm256_add_ps(p_num1, _mm256_mul_ps(v, p_num2))));
+        p = _mm256_div_ps(num, den);
+        p = _mm256_add_ps(p_out0, _mm256_mul_ps(p, _mm256_add_ps(p_out1, _mm256_mul_ps(p_out2, p))));
+        div0 = _mm256_cmp_ps(den, _mm256_setzero_ps(), _CMP_EQ_OQ);
+        bad_p = _mm256_or_ps(div0, _mm256_or_ps(_mm256_cmp_ps(p, p_min, _CMP_LT_OQ), _mm256_cmp_ps(p, p_max, _CMP_GT_OQ)));
+        p = _mm256_andnot_ps(div0, _mm256_min_ps(_mm256_max_ps(p, p_min), p_max));
+
+        _mm256_storeu_ps(temperature_c + i, t);
+        _mm256_storeu_ps(pressure_pa + i, p);
+        clamped += a_bmp280_batch_flags(status != NULL ? status + i : NULL,
+                                        _mm256_movemask_ps(bad_t), _mm256_movemask_ps(bad_p), 8);
+    }
+
+    return clamped;
+}
+
+#endif
+
+#endif
+
+#if defined(BMP280_BATCH_NEON)
+
+/**
+ * @brief      compensate samples four at a time with neon
+ * @param[in]  *coeff pointer to a bmp280 coefficients structure
+ * @param[in]  *temperature_raw pointer to a raw temperature array
+ * @param[in]  *pressure_raw pointer to a raw pressure array
+ * @param[out] *temperature_c pointer to a temperature array
+ * @param[out] *pressure_pa pointer to a pressure array
+ * @param[out] *status pointer to a status array, may be NULL
+ * @param[in]  count number of samples, a multiple of 4
+ * @return     number of samples with a clamped value
+ * @note       aarch64 only, armv7 neon has no vector divide
+ */
+static uint32_t a_bmp280_batch_neon(const bmp280_coefficients_t *coeff,
+                                    const uint32_t *temperature_raw, const uint32_t *pressure_raw,
+                                    float *temperature_c, float *pressure_pa, uint8_t *status, uint32_t count)
+{
+    const float32x4_t t_offset = vdupq_n_f32(coeff->t_offset);
+    const float32x4_t t_lin = vdupq_n_f32(coeff->t_lin);
+    const float32x4_t t_quad = vdupq_n_f32(coeff->t_quad);
+    const float32x4_t p_num0 = vdupq_n_f32(coeff->p_num0);
+    const float32x4_t p_num1 = vdupq_n_f32(coeff->p_num1);
+    const float32x4_t p_num2 = vdupq_n_f32(coeff->p_num2);
+    const float32x4_t p_den0 = vdupq_n_f32(coeff->p_den0);
+    const float32x4_t p_den1 = vdupq_n_f32(coeff->p_den1);
+    const float32x4_t p_den2 = vdupq_n_f32(coeff->p_den2);
+    const float32x4_t p_out0 = vdupq_n_f32(coeff->p_out0);
+    const float32x4_t p_out1 = vdupq_n_f32(coeff->p_out1);
+    const float32x4_t p_out2 = vdupq_n_f32(coeff->p_out2);
+    const float32x4_t t_min = vdupq_n_f32(-40.0f);
+    const float32x4_t t_max = vdupq_n_f32(85.0f);
+    const float32x4_t p_min = vdupq_n_f32(30000.0f);
+    const float32x4_t p_max = vdupq_n_f32(110000.0f);
+    uint32_t i;
+    uint32_t j;
+    uint32_t clamped;
+    uint32_t bad_t_lane[4];
+    uint32_t bad_p_lane[4];
+    uint8_t flags;
+
+    clamped = 0;
+    for (i = 0; i < count; i += 4)
+    {
+        float32x4_t raw_t = vcvtq_f32_u32(vld1q_u32(temperature_raw + i));
+        float32x4_t raw_p = vcvtq_f32_u32(vld1q_u32(pressure_raw + i));
+        float32x4_t x, sum, t_fine, t, v, num, den, p;
+        uint32x4_t bad_t, bad_p, div0;
+
+        /* temperature */
+        x = vaddq_f32(vmulq_f32(raw_t, vdupq_n_f32(1.0f / 131072.0f)), t_offset);
+        sum = vmulq_f32(x, vaddq_f32(t_lin, vmulq_f32(t_quad, x)));
+        t_fine = vcvtq_f32_s32(vcvtq_s32_f32(sum));
+        t = vmulq_f32(sum, vdupq_n_f32(1.0f / 5120.0f));
+        bad_t = vorrq_u32(vcltq_f32(t, t_min), vcgtq_f32(t, t_max));
+        t = vminq_f32(vmaxq_f32(t, t_min), t_max);
+
+        /* pressure */
+        v = vsubq_f32(vmulq_f32(t_fine, vdupq_n_f32(0.5f)), vdupq_n_f32(64000.0f));
+        den = vaddq_f32(p_den0, vmulq_f32(v, vaddq_f32(p_den1, vmulq_f32(v, p_den2))));
+        num = vsubq_f32(vsubq_f32(p_num0, raw_p), vmulq_f32(v, vaddq_f32(p_num1, vmulq_f32(v, p_num2))));
+        p = vdivq_f32(num, den);
+        p = vaddq_f32(p_out0, vmulq_f32(p, vaddq_f32(p_out1, vmulq_f32(p_out2, p))));
+        div0 = vceqq_f32(den, vdupq_n_f32(0.0f));
+        bad_p = vorrq_u32(div0, vorrq_u32(vcltq_f32(p, p_min), vcgtq_f32(p, p_max)));
+        p = vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(vminq_f32(vmaxq_f32(p, p_min), p_max)), div0));
+
+        vst1q_f32(temperature_c + i, t);
+        vst1q_f32(pressure_pa + i, p);
+        vst1q_u32(bad_t_lane, bad_t);
+        vst1q_u32(bad_p_lane, bad_p);
+        for (j = 0; j < 4; j++)
+        {
+            flags = (uint8_t)((bad_t_lane[j] != 0 ? BMP280_COMPENSATE_TEMPERATURE_RANGE : 0) |
+                              (bad_p_lane[j] != 0 ? BMP280_COMPENSATE_PRESSURE_RANGE : 0));
+            if (status != NULL)
+            {
+                status[i + j] = flags;
+            }
+            clamped += (flags != 0) ? 1 : 0;
+        }
+    }
+
+    return clamped;
+}
+
+#endif
+
+/**
+ * @brief      compensate arrays of raw samples
+ * @param[in]  *calibration pointer to a bmp280 calibration structure
+ * @param[in]  *temperature_raw pointer to a raw temperature array
+ * @param[in]  *pressure_raw pointer to a raw pressure array
+ * @param[out] *temperature_c pointer to a temperature array
+ * @param[out] *pressure_pa pointer to a pressure array
+ * @param[out] *status pointer to a status array, may be NULL
+ * @param[in]  count number of samples
+ * @return     number of samples with a clamped value
+ * @note       none
+ */
+uint32_t bmp280_compensate_batch(const bmp280_calibration_t *calibration,
+                                 const uint32_t *temperature_raw, const uint32_t *pressure_raw,
+                                 float *temperature_c, float *pressure_pa, uint8_t *status, uint32_t count)
+{
+    bmp280_coefficients_t coeff;
+    uint32_t done;
+    uint32_t clamped;
+
+    coeff = bmp280_compile_calibration(calibration);                                                       /* fold once per batch */
+    done = 0;                                                                                              /* init 0 */
+    clamped = 0;                                                                                           /* init 0 */
+#if defined(BMP280_BATCH_X86)
+#if defined(__GNUC__)
+    if (__builtin_cpu_supports("avx2") != 0)                                                               /* check avx2 */
+    {
+        done = count & ~7U;                                                                                /* whole vectors */
+        clamped += a_bmp280_batch_avx2(&coeff, temperature_raw, pressure_raw,
+                                       temperature_c, pressure_pa, status, done);                          /* avx2 */
+    }
+#endif
+    if (done == 0)                                                                                         /* no avx2 */
+    {
+        done = count & ~3U;                                                                                /* whole vectors */
+        clamped += a_bmp280_batch_sse2(&coeff, temperature_raw, pressure_raw,
+                                       temperature_c, pressure_pa, status, done);                          /* sse2 */
+    }
+#elif defined(BMP280_BATCH_NEON)
+    done = count & ~3U;                                                                                    /* whole vectors */
+    clamped += a_bmp280_batch_neon(&coeff, temperature_raw, pressure_raw,
+                                   temperature_c, pressure_pa, status, done);                              /* neon */
+#endif
+    clamped += a_bmp280_batch_scalar(&coeff, temperature_raw + done, pressure_raw + done,
+                                     temperature_c + done, pressure_pa + done,
+                                     status != NULL ? status + done : NULL, count - done);                 /* tail */
+
+    return clamped;                                                                                        /* return clamped */
+}